@@ -580,6 +580,10 @@ free_all_mem(void)
     vim_tcl_finalize();
 # endif
     clear_hl_tables();
+# ifdef FEAT_EVAL
+    // must be after everything that frees lists
+    list_free_pool();
+# endif
 
     vim_free(IObuff);
     vim_free(NameBuff);
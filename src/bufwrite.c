@@ -1638,6 +1638,11 @@ buf_write(
     if (buf->b_ml.ml_flags & ML_EMPTY)
 	start = end + 1;
 
+    // Text that was not changed may still be read from the original file,
+    // get it before the file is overwritten.
+    if (overwriting)
+	ml_close_source(buf);
+
     // If the original file is being overwritten, there is a small chance that
     // we crash in the middle of writing. Therefore the file is preserved now.
     // This makes all block numbers positive so that recovery does not need
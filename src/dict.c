@@ -294,6 +294,8 @@ dict_copy(dict_T *orig, int deep, int top, int copyID)
     dictitem_T	*di;
     int		todo;
     hashitem_T	*hi;
+    hashitem_T	*new_hi;
+    int		locked;
 
     if (orig == NULL)
 	return NULL;
@@ -312,6 +314,8 @@ dict_copy(dict_T *orig, int deep, int top, int copyID)
 	    copy->dv_type = alloc_type(orig->dv_type);
 
 	todo = (int)orig->dv_hashtab.ht_used;
+	// Make room for all items at once.
+	locked = hash_lock_add(&copy->dv_hashtab, todo) == OK;
 	for (hi = orig->dv_hashtab.ht_array; todo > 0 && !got_int; ++hi)
 	{
 	    if (!HASHITEM_EMPTY(hi))
@@ -332,13 +336,20 @@ dict_copy(dict_T *orig, int deep, int top, int copyID)
 		}
 		else
 		    copy_tv(&HI2DI(hi)->di_tv, &di->di_tv);
-		if (dict_add(copy, di) == FAIL)
+
+		// The keys are unique, the hash can be reused.
+		new_hi = hash_lookup(&copy->dv_hashtab, di->di_key,
+								  hi->hi_hash);
+		if (hash_add_item(&copy->dv_hashtab, new_hi, di->di_key,
+							  hi->hi_hash) == FAIL)
 		{
 		    dictitem_free(di);
 		    break;
 		}
 	    }
 	}
+	if (locked)
+	    hash_unlock(&copy->dv_hashtab);
 
 	++copy->dv_refcount;
 	if (todo > 0)
@@ -1092,6 +1103,7 @@ dict_extend(dict_T *d1, dict_T *d2, char_u *action, char *func_name)
     int		todo;
     char_u	*arg_errmsg = (char_u *)N_("extend() argument");
     type_T	*type;
+    int		locked;
 
     if (d1->dv_type != NULL && d1->dv_type->tt_member != NULL)
 	type = d1->dv_type->tt_member;
@@ -1099,6 +1111,8 @@ dict_extend(dict_T *d1, dict_T *d2, char_u *action, char *func_name)
 	type = NULL;
 
     todo = (int)d2->dv_hashtab.ht_used;
+    // Make room for adding all items at once.
+    locked = d1 != d2 && hash_lock_add(&d1->dv_hashtab, todo) == OK;
     for (hi2 = d2->dv_hashtab.ht_array; todo > 0; ++hi2)
     {
 	if (!HASHITEM_EMPTY(hi2))
@@ -1145,6 +1159,8 @@ dict_extend(dict_T *d1, dict_T *d2, char_u *action, char *func_name)
 	    }
 	}
     }
+    if (locked)
+	hash_unlock(&d1->dv_hashtab);
 }
 
 /*
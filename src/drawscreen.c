@@ -153,6 +153,9 @@ update_screen(int type_arg)
     }
     updating_screen = TRUE;
 
+    // Collect the output, so that it is written all at once.
+    out_frame_start();
+
 #ifdef FEAT_PROP_POPUP
     // Update popup_mask if needed.  This may set w_redraw_top and w_redraw_bot
     // in some windows.
@@ -364,6 +367,8 @@ update_screen(int type_arg)
 	maybe_intro_message();
     did_intro = TRUE;
 
+    out_frame_end();
+
 #ifdef FEAT_GUI
     // Redraw the cursor and update the scrollbars when all screen updating is
     // done.
@@ -1396,6 +1401,257 @@ fold_line(
 }
 #endif
 
+/*
+ * Cache of the screen cells of lines drawn with win_line().  When a line is
+ * displayed again, e.g. when scrolling back, and nothing that influences how
+ * it is displayed has changed, the cells are copied to the screen instead of
+ * drawing the line again.  An entry is valid for the same text, window width,
+ * 'leftcol' and saved syntax states.  All entries of a window are invalidated
+ * by incrementing w_linecache_tick, this is done when the window is redrawn
+ * with a type above VALID or lines are redrawn for another reason than a text
+ * change.
+ * The cursor line and lines in a window where the display depends on the
+ * cursor position, Visual mode or highlighted matches are not cached.
+ * The number of entries is a power of two that fits about two window heights,
+ * the cell memory of an entry is only allocated when a line is stored in it.
+ */
+#define LINECACHE_MAXSIZE	256	// maximum number of entries
+
+typedef struct linecache_S
+{
+    linenr_T	lc_lnum;	// buffer line number, zero when not used
+    varnumber_T	lc_changedtick;	// b:changedtick when stored
+    int		lc_tick;	// w_linecache_tick when stored
+#ifdef FEAT_SYN_HL
+    int		lc_sst_generation; // b_sst_generation when stored
+#endif
+    colnr_T	lc_leftcol;	// w_leftcol when stored
+    int		lc_width;	// w_width when stored
+    int		lc_mco;		// Screen_mco when stored
+    int		lc_rows;	// number of screen lines
+    char_u	*lc_data;	// allocated memory for the cells
+} linecache_T;
+
+/*
+ * Return the number of bytes needed for one cell in the line cache.
+ */
+    static int
+linecache_cellsize(void)
+{
+    int size = sizeof(schar_T) + sizeof(sattr_T);
+
+    if (enc_utf8)
+	size += sizeof(u8char_T) * (1 + Screen_mco);
+    if (enc_dbcs == DBCS_JPNU)
+	size += sizeof(schar_T);
+    return size;
+}
+
+/*
+ * Copy "len" cells between the line cache memory "data", which has room for
+ * "total" cells, at cell "idx" and the screen at offset "off".  When
+ * "to_screen" is TRUE copy to the screen, otherwise from the screen.
+ */
+    static void
+linecache_copy(
+	char_u	    *data,
+	int	    total,
+	int	    idx,
+	unsigned    off,
+	int	    len,
+	int	    to_screen)
+{
+    char_u  *p = data;
+    int	    i;
+
+#define LC_COPY(arr, type) \
+    if (to_screen) \
+	mch_memmove((arr) + off, (type *)p + idx, sizeof(type) * len); \
+    else \
+	mch_memmove((type *)p + idx, (arr) + off, sizeof(type) * len); \
+    p += sizeof(type) * total
+
+    // The arrays with the largest items go first, for alignment.
+    if (enc_utf8)
+    {
+	LC_COPY(ScreenLinesUC, u8char_T);
+	for (i = 0; i < Screen_mco; ++i)
+	{
+	    LC_COPY(ScreenLinesC[i], u8char_T);
+	}
+    }
+    LC_COPY(ScreenAttrs, sattr_T);
+    LC_COPY(ScreenLines, schar_T);
+    if (enc_dbcs == DBCS_JPNU)
+    {
+	LC_COPY(ScreenLines2, schar_T);
+    }
+#undef LC_COPY
+}
+
+/*
+ * Return TRUE when line "lnum" in window "wp" may be stored in or taken from
+ * the line cache.
+ */
+    static int
+linecache_usable(win_T *wp, linenr_T lnum)
+{
+    if (ScreenLines == NULL
+	    || lnum == wp->w_cursor.lnum
+	    || (lnum == wp->w_topline && wp->w_skipcol > 0)
+	    || VIsual_active
+	    || WIN_IS_POPUP(wp)
+	    || bt_quickfix(wp->w_buffer)
+	    || bt_terminal(wp->w_buffer)
+#ifdef FEAT_RIGHTLEFT
+	    || wp->w_p_rl
+#endif
+#ifdef FEAT_SYN_HL
+	    || wp->w_p_cuc
+	    || wp->w_p_cul
+#endif
+	    || wp->w_p_rnu
+#ifdef FEAT_SPELL
+	    || wp->w_p_spell
+#endif
+#ifdef FEAT_DIFF
+	    || wp->w_p_diff
+#endif
+#ifdef FEAT_FOLDING
+	    || compute_foldcolumn(wp, 0) > 0
+#endif
+#ifdef FEAT_PROP_POPUP
+	    || wp->w_buffer->b_has_textprop
+#endif
+#ifdef FEAT_SEARCH_EXTRA
+	    || screen_search_hl.rm.regprog != NULL
+	    || wp->w_match_head != NULL
+#endif
+	    )
+	return FALSE;
+    return TRUE;
+}
+
+/*
+ * Display line "lnum" of window "wp" at row "startrow" from the line cache.
+ * Returns the row below the line, or -1 when the line is not in the cache.
+ */
+    static int
+linecache_draw(win_T *wp, linenr_T lnum, int startrow)
+{
+    linecache_T	*lc;
+    int		i;
+    int		screen_row;
+    unsigned	off = (unsigned)(current_ScreenLine - ScreenLines);
+
+    if (wp->w_linecache == NULL || !linecache_usable(wp, lnum))
+	return -1;
+    lc = &wp->w_linecache[lnum & (wp->w_linecache_size - 1)];
+    if (lc->lc_lnum != lnum
+	    || lc->lc_changedtick != CHANGEDTICK(wp->w_buffer)
+	    || lc->lc_tick != wp->w_linecache_tick
+#ifdef FEAT_SYN_HL
+	    || lc->lc_sst_generation != wp->w_s->b_sst_generation
+#endif
+	    || lc->lc_leftcol != wp->w_leftcol
+	    || lc->lc_width != wp->w_width
+	    || lc->lc_mco != Screen_mco
+	    || startrow + lc->lc_rows > wp->w_height)
+	return -1;
+
+    for (i = 0; i < lc->lc_rows; ++i)
+    {
+	screen_row = W_WINROW(wp) + startrow + i;
+	linecache_copy(lc->lc_data, lc->lc_rows * lc->lc_width,
+			    i * lc->lc_width, off, lc->lc_width, TRUE);
+	screen_line(screen_row, wp->w_wincol, wp->w_width, wp->w_width, 0);
+	// Remember that the line wraps, used for modeless copy.
+	if (i < lc->lc_rows - 1 && wp->w_width == Columns)
+	    LineWraps[screen_row] = TRUE;
+    }
+    return startrow + lc->lc_rows;
+}
+
+/*
+ * Store line "lnum" of window "wp", which was just drawn in rows "startrow"
+ * to "endrow" (exclusive), in the line cache.
+ */
+    static void
+linecache_store(win_T *wp, linenr_T lnum, int startrow, int endrow)
+{
+    linecache_T	*lc;
+    int		rows = endrow - startrow;
+    int		size;
+    int		i;
+
+    if (rows <= 0 || endrow > wp->w_height
+	    || W_WINROW(wp) + endrow > Rows
+#ifdef FEAT_PROP_POPUP
+	    // a popup window may cover some of the cells
+	    || popup_visible
+#endif
+#ifdef FEAT_SYN_HL
+	    // Without a saved state the line may have been highlighted from
+	    // a guess made when syncing.
+	    || (syntax_present(wp) && !syntax_has_saved_state(wp, lnum))
+#endif
+	    || !linecache_usable(wp, lnum))
+	return;
+
+    // Use a power of two for the size, it grows with the window height.
+    for (size = 16; size < LINECACHE_MAXSIZE && size < wp->w_height * 2;
+								   size *= 2)
+	;
+    if (wp->w_linecache == NULL || wp->w_linecache_size < size)
+    {
+	linecache_free(wp);
+	wp->w_linecache = ALLOC_CLEAR_MULT(linecache_T, size);
+	if (wp->w_linecache == NULL)
+	    return;
+	wp->w_linecache_size = size;
+    }
+    lc = &wp->w_linecache[lnum & (wp->w_linecache_size - 1)];
+    if (lc->lc_data == NULL || lc->lc_rows != rows
+	    || lc->lc_width != wp->w_width || lc->lc_mco != Screen_mco)
+    {
+	vim_free(lc->lc_data);
+	lc->lc_lnum = 0;
+	lc->lc_data = alloc(linecache_cellsize() * rows * wp->w_width);
+	if (lc->lc_data == NULL)
+	    return;
+    }
+    lc->lc_lnum = lnum;
+    lc->lc_changedtick = CHANGEDTICK(wp->w_buffer);
+    lc->lc_tick = wp->w_linecache_tick;
+#ifdef FEAT_SYN_HL
+    lc->lc_sst_generation = wp->w_s->b_sst_generation;
+#endif
+    lc->lc_leftcol = wp->w_leftcol;
+    lc->lc_width = wp->w_width;
+    lc->lc_mco = Screen_mco;
+    lc->lc_rows = rows;
+    for (i = 0; i < rows; ++i)
+	linecache_copy(lc->lc_data, rows * wp->w_width, i * wp->w_width,
+		LineOffset[W_WINROW(wp) + startrow + i] + wp->w_wincol,
+							   wp->w_width, FALSE);
+}
+
+/*
+ * Free the line cache of window "wp".
+ */
+    void
+linecache_free(win_T *wp)
+{
+    int		i;
+
+    if (wp->w_linecache == NULL)
+	return;
+    for (i = 0; i < wp->w_linecache_size; ++i)
+	vim_free(wp->w_linecache[i].lc_data);
+    VIM_CLEAR(wp->w_linecache);
+    wp->w_linecache_size = 0;
+}
+
 /*
  * Update a single window.
  *
@@ -1499,6 +1755,10 @@ win_update(win_T *wp)
 
     type = wp->w_redr_type;
 
+    // Lines may be displayed differently now, cached lines can't be used.
+    if (type > VALID || wp->w_redraw_top != 0)
+	++wp->w_linecache_tick;
+
     if (type == NOT_VALID)
     {
 	wp->w_redr_status = TRUE;
@@ -2468,17 +2728,26 @@ win_update(win_T *wp)
 		    syntax_end_parsing(syntax_last_parsed + 1);
 #endif
 
-		// Display one line.
-		row = win_line(wp, lnum, srow, wp->w_height,
+		// Display one line, from the line cache if possible.
+		row = linecache_draw(wp, lnum, srow);
+		if (row < 0)
+		{
+		    row = win_line(wp, lnum, srow, wp->w_height,
 							  mod_top == 0, FALSE);
+		    linecache_store(wp, lnum, srow, row);
+#ifdef FEAT_SYN_HL
+		    did_update = DID_LINE;
+		    syntax_last_parsed = lnum;
+#endif
+		}
+#ifdef FEAT_SYN_HL
+		else
+		    did_update = DID_NONE;
+#endif
 
 #ifdef FEAT_FOLDING
 		wp->w_lines[idx].wl_folded = FALSE;
 		wp->w_lines[idx].wl_lastlnum = lnum;
-#endif
-#ifdef FEAT_SYN_HL
-		did_update = DID_LINE;
-		syntax_last_parsed = lnum;
 #endif
 	    }
 
@@ -3192,9 +3461,15 @@ redraw_buf_line_later(buf_T *buf, linenr_T lnum)
     win_T	*wp;
 
     FOR_ALL_WINDOWS(wp)
-	if (wp->w_buffer == buf && lnum >= wp->w_topline
-						  && lnum < wp->w_botline)
+    {
+	if (wp->w_buffer != buf)
+	    continue;
+	if (lnum >= wp->w_topline && lnum < wp->w_botline)
 	    redrawWinline(wp, lnum);
+	else
+	    // the line may be in the line cache
+	    ++wp->w_linecache_tick;
+    }
 }
 #endif
 
@@ -3259,3 +3259,5 @@ EXTERN char e_nfa_regexp_missing_value_in_chr[]
 	INIT(= N_("E1273: (NFA regexp) missing value in '\\%%%c'"));
 EXTERN char e_no_script_file_name_to_substitute_for_script[]
 	INIT(= N_("E1274: No script file name to substitute for \"<script>\""));
+EXTERN char e_cannot_read_block_from_original_file[]
+	INIT(= N_("E1275: Cannot read block from the original file"));
@@ -29,6 +29,17 @@
  */
 static int current_copyID = 0;
 
+/*
+ * Statistics about garbage collection, for gcinfo().
+ */
+static long gc_count = 0;	// number of collections
+static long gc_last_msec = 0;	// time used by the last collection
+static long gc_max_msec = 0;	// longest time used by a collection
+static long gc_total_msec = 0;	// time used by all collections
+static long gc_marked = 0;	// lists and dicts marked in last collection
+static long gc_scanned = 0;	// list and dict items checked in last one
+static int  gc_freed = FALSE;	// last collection freed something
+
 /*
  * Info used by a ":for" loop.
  */
@@ -4718,6 +4729,11 @@ garbage_collect(int testing)
     win_T	*wp;
     int		did_free = FALSE;
     tabpage_T	*tp;
+#ifdef ELAPSED_FUNC
+    elapsed_T	start_tv;
+
+    ELAPSED_INIT(start_tv);
+#endif
 
     if (!testing)
     {
@@ -4726,6 +4742,8 @@ garbage_collect(int testing)
 	may_garbage_collect = FALSE;
 	garbage_collect_at_exit = FALSE;
     }
+    gc_marked = 0;
+    gc_scanned = 0;
 
     // The execution stack can grow big, limit the size.
     if (exestack.ga_maxlen - exestack.ga_len > 500)
@@ -4881,9 +4899,33 @@ garbage_collect(int testing)
 	verb_msg(_("Not enough memory to set references, garbage collection aborted!"));
     }
 
+    ++gc_count;
+    gc_freed = did_free;
+#ifdef ELAPSED_FUNC
+    gc_last_msec = ELAPSED_FUNC(start_tv);
+    gc_total_msec += gc_last_msec;
+    if (gc_last_msec > gc_max_msec)
+	gc_max_msec = gc_last_msec;
+#endif
+
     return did_free;
 }
 
+/*
+ * Add statistics about garbage collection to dict "d", for gcinfo().
+ */
+    void
+garbage_collect_info(dict_T *d)
+{
+    dict_add_number(d, "count", (varnumber_T)gc_count);
+    dict_add_number(d, "lasttime", (varnumber_T)gc_last_msec);
+    dict_add_number(d, "maxtime", (varnumber_T)gc_max_msec);
+    dict_add_number(d, "totaltime", (varnumber_T)gc_total_msec);
+    dict_add_number(d, "marked", (varnumber_T)gc_marked);
+    dict_add_number(d, "scanned", (varnumber_T)gc_scanned);
+    dict_add_number(d, "freed", (varnumber_T)gc_freed);
+}
+
 /*
  * Free lists, dictionaries, channels and jobs that are no longer referenced.
  */
@@ -4964,12 +5006,16 @@ set_ref_in_ht(hashtab_T *ht, int copyID, list_stack_T **list_stack)
 	    // it is added to ht_stack, if it contains a list it is added to
 	    // list_stack.
 	    todo = (int)cur_ht->ht_used;
+	    gc_scanned += todo;
 	    for (hi = cur_ht->ht_array; todo > 0; ++hi)
 		if (!HASHITEM_EMPTY(hi))
 		{
 		    --todo;
-		    abort = abort || set_ref_in_item(&HI2DI(hi)->di_tv, copyID,
-						       &ht_stack, list_stack);
+		    // A string can't refer to anything either.
+		    if (!TV_HAS_NO_ALLOC(&HI2DI(hi)->di_tv)
+				&& HI2DI(hi)->di_tv.v_type != VAR_STRING)
+			abort = abort || set_ref_in_item(&HI2DI(hi)->di_tv,
+					       copyID, &ht_stack, list_stack);
 		}
 	}
 
@@ -5042,8 +5088,14 @@ set_ref_in_list_items(list_T *l, int copyID, ht_stack_T **ht_stack)
 	    // it is added to ht_stack, if it contains a list it is added to
 	    // list_stack.
 	    for (li = cur_l->lv_first; !abort && li != NULL; li = li->li_next)
-		abort = abort || set_ref_in_item(&li->li_tv, copyID,
+	    {
+		++gc_scanned;
+		// Numbers and strings are common, skip the function call.
+		if (!TV_HAS_NO_ALLOC(&li->li_tv)
+					       && li->li_tv.v_type != VAR_STRING)
+		    abort = set_ref_in_item(&li->li_tv, copyID,
 						       ht_stack, &list_stack);
+	    }
 	if (list_stack == NULL)
 	    break;
 
@@ -5097,6 +5149,7 @@ set_ref_in_item(
 	{
 	    // Didn't see this dict yet.
 	    dd->dv_copyID = copyID;
+	    ++gc_marked;
 	    if (ht_stack == NULL)
 	    {
 		abort = set_ref_in_ht(&dd->dv_hashtab, copyID, list_stack);
@@ -5124,6 +5177,7 @@ set_ref_in_item(
 	{
 	    // Didn't see this list yet.
 	    ll->lv_copyID = copyID;
+	    ++gc_marked;
 	    if (list_stack == NULL)
 	    {
 		abort = set_ref_in_list_items(ll, copyID, ht_stack);
@@ -123,6 +123,28 @@ find_win_for_curbuf(void)
     }
 }
 
+/*
+ * Append the lines in "gap" below line "*lnum" and free them.  "*lnum" is
+ * advanced to the last appended line.
+ */
+    static int
+append_new_lines(garray_T *gap, linenr_T *lnum)
+{
+    int		ret = OK;
+    int		i;
+
+    if (gap->ga_len == 0)
+	return OK;
+    if (ml_append_bulk(*lnum, (char_u **)gap->ga_data, gap->ga_len, 0)
+								       == FAIL)
+	ret = FAIL;
+    *lnum += gap->ga_len;
+    for (i = 0; i < gap->ga_len; ++i)
+	vim_free(((char_u **)gap->ga_data)[i]);
+    gap->ga_len = 0;
+    return ret;
+}
+
 /*
  * Set line or list of lines in buffer "buf" to "lines".
  * Any type is allowed and converted to a string.
@@ -144,6 +166,8 @@ set_buffer_lines(
     buf_T	*curbuf_save = NULL;
     win_T	*curwin_save = NULL;
     int		is_curbuf = buf == curbuf;
+    garray_T	new_lines;		// lines to be appended
+    linenr_T	new_lnum;		// append "new_lines" below this line
 
     // When using the current buffer ml_mfp will be set if needed.  Useful when
     // setline() is used on startup.  For other buffers the buffer must be
@@ -188,6 +212,9 @@ set_buffer_lines(
     else
 	line = typval_tostring(lines, FALSE);
 
+    ga_init2(&new_lines, sizeof(char_u *), 100);
+    new_lnum = append_lnum;
+
     // default result is zero == OK
     for (;;)
     {
@@ -202,7 +229,8 @@ set_buffer_lines(
 	}
 
 	rettv->vval.v_number = 1;	// FAIL
-	if (line == NULL || lnum > curbuf->b_ml.ml_line_count + 1)
+	if (line == NULL
+		  || lnum > curbuf->b_ml.ml_line_count + new_lines.ga_len + 1)
 	    break;
 
 	// When coming here from Insert mode, sync undo, so that this can be
@@ -228,10 +256,18 @@ set_buffer_lines(
 	}
 	else if (added > 0 || u_save(lnum - 1, lnum) == OK)
 	{
-	    // append the line
+	    // Collect the lines to append, they are appended in batches, which
+	    // is faster than one by one.
 	    ++added;
-	    if (ml_append(lnum - 1, line, (colnr_T)0, FALSE) == OK)
+	    if (ga_grow(&new_lines, 1) == OK)
+	    {
+		((char_u **)new_lines.ga_data)[new_lines.ga_len++] = line;
+		line = NULL;
 		rettv->vval.v_number = 0;	// OK
+	    }
+	    if (new_lines.ga_len >= 100 && append_new_lines(&new_lines,
+						       &new_lnum) == FAIL)
+		rettv->vval.v_number = 1;	// FAIL
 	}
 
 	if (l == NULL)			// only one string argument
@@ -240,6 +276,10 @@ set_buffer_lines(
     }
     vim_free(line);
 
+    if (append_new_lines(&new_lines, &new_lnum) == FAIL)
+	rettv->vval.v_number = 1;	// FAIL
+    ga_clear(&new_lines);
+
     if (added > 0)
     {
 	win_T	    *wp;
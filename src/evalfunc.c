@@ -58,6 +58,7 @@ static void f_foreground(typval_T *argvars, typval_T *rettv);
 static void f_funcref(typval_T *argvars, typval_T *rettv);
 static void f_function(typval_T *argvars, typval_T *rettv);
 static void f_garbagecollect(typval_T *argvars, typval_T *rettv);
+static void f_gcinfo(typval_T *argvars, typval_T *rettv);
 static void f_get(typval_T *argvars, typval_T *rettv);
 static void f_getchangelist(typval_T *argvars, typval_T *rettv);
 static void f_getcharpos(typval_T *argvars, typval_T *rettv);
@@ -103,6 +104,7 @@ static void f_matchlist(typval_T *argvars, typval_T *rettv);
 static void f_matchstr(typval_T *argvars, typval_T *rettv);
 static void f_matchstrpos(typval_T *argvars, typval_T *rettv);
 static void f_max(typval_T *argvars, typval_T *rettv);
+static void f_memfileinfo(typval_T *argvars, typval_T *rettv);
 static void f_min(typval_T *argvars, typval_T *rettv);
 #ifdef FEAT_MZSCHEME
 static void f_mzeval(typval_T *argvars, typval_T *rettv);
@@ -1815,6 +1817,8 @@ static funcentry_T global_functions[] =
 			ret_func_unknown,   f_function},
     {"garbagecollect",	0, 1, 0,	    arg1_bool,
 			ret_void,	    f_garbagecollect},
+    {"gcinfo",		0, 0, 0,	    NULL,
+			ret_dict_number,    f_gcinfo},
     {"get",		2, 3, FEARG_1,	    arg23_get,
 			ret_any,	    f_get},
     {"getbufinfo",	0, 1, FEARG_1,	    arg1_buffer_or_dict_any,
@@ -2075,6 +2079,8 @@ static funcentry_T global_functions[] =
 			ret_list_any,	    f_matchstrpos},
     {"max",		1, 1, FEARG_1,	    arg1_list_or_dict,
 			ret_number,	    f_max},
+    {"memfileinfo",	0, 1, FEARG_1,	    arg1_buffer,
+			ret_dict_number,    f_memfileinfo},
     {"menu_info",	1, 2, FEARG_1,	    arg2_string,
 			ret_dict_any,
 #ifdef FEAT_MENU
@@ -4597,6 +4603,16 @@ f_garbagecollect(typval_T *argvars, typval_T *rettv UNUSED)
 	garbage_collect_at_exit = TRUE;
 }
 
+/*
+ * "gcinfo()" function
+ */
+    static void
+f_gcinfo(typval_T *argvars UNUSED, typval_T *rettv)
+{
+    if (rettv_dict_alloc(rettv) == OK)
+	garbage_collect_info(rettv->vval.v_dict);
+}
+
 /*
  * "get()" function
  */
@@ -7609,6 +7625,39 @@ f_max(typval_T *argvars, typval_T *rettv)
     max_min(argvars, rettv, TRUE);
 }
 
+/*
+ * "memfileinfo([{buf}])" function
+ */
+    static void
+f_memfileinfo(typval_T *argvars, typval_T *rettv)
+{
+    buf_T	*buf = curbuf;
+    memfile_T	*mfp;
+    dict_T	*d;
+
+    if (in_vim9script() && check_for_opt_buffer_arg(argvars, 0) == FAIL)
+	return;
+
+    if (rettv_dict_alloc(rettv) == FAIL)
+	return;
+    if (argvars[0].v_type != VAR_UNKNOWN)
+	buf = tv_get_buf(&argvars[0], FALSE);
+    if (buf == NULL || (mfp = buf->b_ml.ml_mfp) == NULL)
+	return;
+
+    d = rettv->vval.v_dict;
+    dict_add_number(d, "pages", (varnumber_T)mfp->mf_used_count);
+    dict_add_number(d, "hotpages", (varnumber_T)mfp->mf_hot_count);
+    dict_add_number(d, "maxpages", (varnumber_T)mfp->mf_used_count_max);
+    dict_add_number(d, "pagesize", (varnumber_T)mfp->mf_page_size);
+    dict_add_number(d, "hits", (varnumber_T)mfp->mf_hits);
+    dict_add_number(d, "misses", (varnumber_T)mfp->mf_misses);
+    dict_add_number(d, "evictions", (varnumber_T)mfp->mf_evictions);
+    dict_add_number(d, "compressed", (varnumber_T)mfp->mf_zip_count);
+    dict_add_number(d, "compressedsize", (varnumber_T)mfp->mf_zip_size);
+    dict_add_number(d, "compressedhits", (varnumber_T)mfp->mf_zip_hits);
+}
+
 /*
  * "min()" function
  */
@@ -40,6 +40,9 @@ static char_u *readfile_charconvert(char_u *fname, char_u *fenc, int *fdp);
 static char_u *check_for_cryptkey(char_u *cryptkey, char_u *ptr, long *sizep, off_T *filesizep, int newfile, char_u *fname, int *did_ask);
 #endif
 static linenr_T readfile_linenr(linenr_T linecnt, char_u *p, char_u *endp);
+#ifdef UNIX
+static int readfile_open_src(char_u *fname, int fd);
+#endif
 static char_u *check_for_bom(char_u *p, long size, int *lenp, int flags);
 
 #ifdef FEAT_EVAL
@@ -217,6 +220,9 @@ readfile(
     int		using_b_fname;
     static char *msg_is_a_directory = N_("is a directory");
     int         eof;
+    int		use_src = FALSE;	// unchanged blocks can be read from
+					// the file later
+    int		src_ok = FALSE;		// text read is equal to the file
 
     au_did_filetype = FALSE; // reset before triggering any autocommands
 
@@ -1117,6 +1123,16 @@ retry:
 #endif
     }
 
+#ifdef UNIX
+    // When the file does not fit in 'maxmem', blocks that are not changed
+    // can be read from the file again instead of writing them to the swap
+    // file.
+    if (!use_src && newfile && !filtering && !read_stdin && !read_buffer
+	    && !read_fifo && lines_to_skip == 0
+	    && curbuf->b_ml.ml_mfp != NULL && (filesize_disk >> 10) >= p_mm)
+	use_src = readfile_open_src(fname, fd);
+#endif
+
     while (!error && !got_int)
     {
 	/*
@@ -2144,6 +2160,14 @@ rewind_retry:
 	    }
 	}
 
+	// Without conversion the text of the lines is what is in the file.
+	src_ok = use_src && !converted && fileformat == EOL_UNIX
+					    && split == 0 && illegal_byte == 0
+#ifdef FEAT_CRYPT
+					    && cryptkey == NULL
+#endif
+					    ;
+
 	/*
 	 * This loop is executed once for every character read.
 	 * Keep it fast!
@@ -2191,11 +2215,31 @@ rewind_retry:
 	}
 	else
 	{
+	    char_u	*eol = NULL;	// next NL in the buffer or the end
+
 	    --ptr;
 	    while (++ptr, --size >= 0)
 	    {
 		if ((c = *ptr) != NUL && c != NL)  // catch most common case
+		{
+		    char_u *nul_or_nl;
+
+		    // Skip to the next NUL or NL with memchr(), which is a lot
+		    // faster than checking every byte.  Remember where the NL
+		    // is, so that many NULs in a long line don't make it slow.
+		    if (eol == NULL || eol < ptr)
+		    {
+			eol = memchr(ptr, NL, (size_t)size + 1);
+			if (eol == NULL)
+			    eol = ptr + size + 1;
+		    }
+		    nul_or_nl = memchr(ptr, NUL, (size_t)(eol - ptr));
+		    if (nul_or_nl == NULL)
+			nul_or_nl = eol;
+		    size -= (long)(nul_or_nl - 1 - ptr);
+		    ptr = nul_or_nl - 1;
 		    continue;
+		}
 		if (c == NUL)
 		    *ptr = NL;	// NULs are replaced by newlines!
 		else
@@ -2236,6 +2280,10 @@ rewind_retry:
 				ff_error = EOL_DOS;
 			    }
 			}
+			// Offset of the line in the file, bytes that were
+			// not converted yet come after the ones in the buffer.
+			curbuf->b_ml.ml_src_off = src_ok ? filesize_count
+			     - conv_restlen - (ptr + 1 + size - line_start) : -1;
 			if (ml_append(lnum, line_start, len, newfile) == FAIL)
 			{
 			    error = TRUE;
@@ -2264,6 +2312,8 @@ rewind_retry:
     }
 
 failed:
+    curbuf->b_ml.ml_src_off = -1;
+
     // not an error, max. number of lines reached
     if (error && read_count == 0)
 	error = FALSE;
@@ -2679,6 +2729,43 @@ is_dev_fd_file(char_u *fname)
 }
 #endif
 
+#ifdef UNIX
+/*
+ * Open file "fname", which is being read with "fd", once more.  Unchanged
+ * blocks of the buffer can be read from it later.
+ * Return TRUE when this worked.
+ */
+    static int
+readfile_open_src(char_u *fname, int fd)
+{
+    int		src_fd;
+    stat_T	st_fd;
+    stat_T	st_src;
+
+    src_fd = mch_open((char *)fname, O_RDONLY | O_EXTRA, 0);
+    if (src_fd < 0)
+	return FALSE;
+
+    // Must be the same regular file.
+    if (mch_fstat(fd, &st_fd) < 0 || mch_fstat(src_fd, &st_src) < 0
+	    || !S_ISREG(st_src.st_mode)
+	    || st_fd.st_dev != st_src.st_dev || st_fd.st_ino != st_src.st_ino)
+    {
+	close(src_fd);
+	return FALSE;
+    }
+# ifdef HAVE_FD_CLOEXEC
+    {
+	int fdflags = fcntl(src_fd, F_GETFD);
+
+	if (fdflags >= 0 && (fdflags & FD_CLOEXEC) == 0)
+	    (void)fcntl(src_fd, F_SETFD, fdflags | FD_CLOEXEC);
+    }
+# endif
+    return mf_set_source(curbuf->b_ml.ml_mfp, src_fd) == OK;
+}
+#endif
+
 /*
  * From the current line count and characters read after that, estimate the
  * line number where we are now.
@@ -1656,6 +1656,9 @@ EXTERN int  disable_vterm_title_for_testing INIT(= FALSE);
 EXTERN long override_sysinfo_uptime INIT(= -1);
 EXTERN int  override_autoload INIT(= FALSE);
 
+// number of times a swap file was flushed to disk, for test_getvalue()
+EXTERN int  swap_sync_count INIT(= 0);
+
 EXTERN int  in_free_unref_items INIT(= FALSE);
 #endif
 
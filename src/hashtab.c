@@ -39,6 +39,16 @@ static long hash_count_perturb = 0;	// count number of "misses"
 // Magic value for algorithm that walks through the array.
 #define PERTURB_SHIFT 5
 
+// Value used for "ht_changed", incremented for every change of any hashtable.
+// Thus a hashtable pointer plus its "ht_changed" value identify the contents
+// of the table, also when the table was freed and another one allocated at
+// the same address.  Used for the Vim9 lookup cache.  It is 64 bits, thus
+// wrapping around won't happen in practice; if it did the cache would only
+// do an unnecessary lookup, since the hashtable pointer is compared as well.
+static uvarnumber_T hash_changed_nr = 0;
+
+#define HASH_CHANGED(ht) (ht)->ht_changed = ++hash_changed_nr
+
 static int hash_may_resize(hashtab_T *ht, int minitems);
 
 #if 0 // currently not used
@@ -68,6 +78,7 @@ hash_init(hashtab_T *ht)
     CLEAR_POINTER(ht);
     ht->ht_array = ht->ht_smallarray;
     ht->ht_mask = HT_INIT_SIZE - 1;
+    HASH_CHANGED(ht);
 }
 
 /*
@@ -236,7 +247,7 @@ hash_add_item(
 	return FAIL;
 
     ++ht->ht_used;
-    ++ht->ht_changed;
+    HASH_CHANGED(ht);
     if (hi->hi_key == NULL)
 	++ht->ht_filled;
     hi->hi_key = key;
@@ -272,7 +283,7 @@ hash_set(hashitem_T *hi, char_u *key)
 hash_remove(hashtab_T *ht, hashitem_T *hi)
 {
     --ht->ht_used;
-    ++ht->ht_changed;
+    HASH_CHANGED(ht);
     hi->hi_key = HI_KEY_REMOVED;
     hash_may_resize(ht, 0);
 }
@@ -288,6 +299,27 @@ hash_lock(hashtab_T *ht)
     ++ht->ht_locked;
 }
 
+/*
+ * Lock a hashtable after making room for adding "count" more items, so that
+ * the array is grown only once instead of several times while adding them.
+ * Caller must make sure no more than "count" entries will be added.
+ * Returns FAIL when the array could not be made big enough, the hashtable is
+ * not locked then.  Otherwise must call hash_unlock() later.
+ */
+    int
+hash_lock_add(hashtab_T *ht, int count)
+{
+    if (ht->ht_locked > 0)
+	return FAIL;
+    // The array must stay less than 2/3 full, like in hash_may_resize().
+    if ((ht->ht_filled + count) * 3 >= (ht->ht_mask + 1) * 2
+	    && (hash_may_resize(ht, (int)ht->ht_used + count) == FAIL
+		|| (ht->ht_filled + count) * 3 >= (ht->ht_mask + 1) * 2))
+	return FAIL;
+    ++ht->ht_locked;
+    return OK;
+}
+
 #if defined(FEAT_PROP_POPUP) || defined(PROTO)
 /*
  * Lock a hashtable at the specified number of entries.
@@ -452,7 +484,7 @@ hash_may_resize(
     ht->ht_array = newarray;
     ht->ht_mask = newmask;
     ht->ht_filled = ht->ht_used;
-    ++ht->ht_changed;
+    HASH_CHANGED(ht);
     ht->ht_error = FALSE;
 
     return OK;
@@ -18,6 +18,29 @@
 // List heads for garbage collection.
 static list_T		*first_list = NULL;	// list of all lists
 
+/*
+ * Lists and list items that are freed are kept for reuse, up to a maximum.
+ * Many lists are only used for a short time, e.g. the result of split() or
+ * map() used in an expression, this avoids calling malloc() and free() for
+ * each of them and for each of their items.
+ */
+#define LIST_POOL_MAX	    64
+#define LISTITEM_POOL_MAX   1024
+
+static list_T		*list_pool = NULL;	// linked with lv_used_next
+static int		list_pool_count = 0;
+static listitem_T	*listitem_pool = NULL;	// linked with li_next
+static int		listitem_pool_count = 0;
+
+/*
+ * When list_find() would have to walk over more than this number of items an
+ * index with pointers to all items is built, so that further lookups in the
+ * same list are a direct access.  The index is dropped when items are
+ * inserted, removed or moved; appending items keeps it valid for the items
+ * before them.
+ */
+#define LIST_INDEX_MIN_WALK 100
+
 #define FOR_ALL_WATCHERS(l, lw) \
     for ((lw) = (l)->lv_watch; (lw) != NULL; (lw) = (lw)->lw_next)
 
@@ -54,6 +77,44 @@ list_rem_watch(list_T *l, listwatch_T *lwrem)
     }
 }
 
+/*
+ * Drop the index of list "l" and the cached item, they are no longer valid
+ * after items were inserted, removed or moved.
+ */
+    static void
+list_index_clear(list_T *l)
+{
+    VIM_CLEAR(l->lv_index);
+    l->lv_index_len = 0;
+    l->lv_u.mat.lv_idx_item = NULL;
+}
+
+/*
+ * Build the index of list "l", with pointers to all its items.
+ * Returns FAIL when out of memory or the list is not allocated.
+ */
+    static int
+list_index_build(list_T *l)
+{
+    listitem_T	**index;
+    listitem_T	*item;
+    int		i = 0;
+
+    // A static list is not freed with list_free_list(), the index would leak.
+    if (l->lv_used_prev == NULL && first_list != l)
+	return FAIL;
+
+    index = ALLOC_MULT(listitem_T *, l->lv_len);
+    if (index == NULL)
+	return FAIL;
+    FOR_ALL_LIST_ITEMS(l, item)
+	index[i++] = item;
+    vim_free(l->lv_index);
+    l->lv_index = index;
+    l->lv_index_len = i;
+    return OK;
+}
+
 /*
  * Just before removing an item from a list: advance watchers to the next
  * item.
@@ -88,7 +149,15 @@ list_alloc(void)
 {
     list_T  *l;
 
-    l = ALLOC_CLEAR_ONE(list_T);
+    if (list_pool != NULL)
+    {
+	l = list_pool;
+	list_pool = l->lv_used_next;
+	--list_pool_count;
+	CLEAR_POINTER(l);
+    }
+    else
+	l = ALLOC_CLEAR_ONE(list_T);
     if (l != NULL)
 	list_init(l);
     return l;
@@ -224,6 +293,7 @@ list_free_contents(list_T *l)
     listitem_T *item;
 
     if (l->lv_first != &range_list_item)
+    {
 	for (item = l->lv_first; item != NULL; item = l->lv_first)
 	{
 	    // Remove the item before deleting it.
@@ -231,6 +301,8 @@ list_free_contents(list_T *l)
 	    clear_tv(&item->li_tv);
 	    list_free_item(l, item);
 	}
+	list_index_clear(l);
+    }
 }
 
 /*
@@ -269,7 +341,15 @@ list_free_list(list_T  *l)
 	l->lv_used_next->lv_used_prev = l->lv_used_prev;
 
     free_type(l->lv_type);
-    vim_free(l);
+    vim_free(l->lv_index);
+    if (l->lv_with_items == 0 && list_pool_count < LIST_POOL_MAX)
+    {
+	l->lv_used_next = list_pool;
+	list_pool = l;
+	++list_pool_count;
+    }
+    else
+	vim_free(l);
 }
 
     void
@@ -308,7 +388,13 @@ list_free(list_T *l)
     listitem_T *
 listitem_alloc(void)
 {
-    return ALLOC_ONE(listitem_T);
+    listitem_T	*item = listitem_pool;
+
+    if (item == NULL)
+	return ALLOC_ONE(listitem_T);
+    listitem_pool = item->li_next;
+    --listitem_pool_count;
+    return item;
 }
 
 /*
@@ -320,8 +406,44 @@ list_free_item(list_T *l, listitem_T *item)
 {
     if (l->lv_with_items == 0 || item < (listitem_T *)l
 			   || item >= (listitem_T *)(l + 1) + l->lv_with_items)
+    {
+	if (listitem_pool_count < LISTITEM_POOL_MAX)
+	{
+	    item->li_next = listitem_pool;
+	    listitem_pool = item;
+	    ++listitem_pool_count;
+	}
+	else
+	    vim_free(item);
+    }
+}
+
+#if defined(EXITFREE) || defined(PROTO)
+/*
+ * Free the lists and list items kept for reuse.
+ */
+    void
+list_free_pool(void)
+{
+    list_T	*l;
+    listitem_T	*item;
+
+    while (list_pool != NULL)
+    {
+	l = list_pool;
+	list_pool = l->lv_used_next;
+	vim_free(l);
+    }
+    list_pool_count = 0;
+    while (listitem_pool != NULL)
+    {
+	item = listitem_pool;
+	listitem_pool = item->li_next;
 	vim_free(item);
+    }
+    listitem_pool_count = 0;
 }
+#endif
 
 /*
  * Free a list item, unless it was allocated together with the list itself.
@@ -412,6 +534,13 @@ list_find(list_T *l, long n)
 
     CHECK_LIST_MATERIALIZE(l);
 
+    if (n < l->lv_index_len)
+    {
+	item = l->lv_index[n];
+	idx = n;
+	goto found;
+    }
+
     // When there is a cached index may start search from there.
     if (l->lv_u.mat.lv_idx_item != NULL)
     {
@@ -450,6 +579,12 @@ list_find(list_T *l, long n)
 	}
     }
 
+    if ((n > idx ? n - idx : idx - n) > LIST_INDEX_MIN_WALK
+						  && list_index_build(l) == OK)
+    {
+	item = l->lv_index[n];
+	idx = n;
+    }
     while (n > idx)
     {
 	// search forward
@@ -463,6 +598,7 @@ list_find(list_T *l, long n)
 	--idx;
     }
 
+found:
     // cache the used index
     l->lv_u.mat.lv_idx = idx;
     l->lv_u.mat.lv_idx_item = item;
@@ -755,6 +891,11 @@ list_insert(list_T *l, listitem_T *ni, listitem_T *item)
 	}
 	item->li_prev = ni;
 	++l->lv_len;
+	if (l->lv_index != NULL)
+	{
+	    VIM_CLEAR(l->lv_index);
+	    l->lv_index_len = 0;
+	}
     }
 }
 
@@ -1285,7 +1426,7 @@ vimlist_remove(list_T *l, listitem_T *item, listitem_T *item2)
 	l->lv_first = item2->li_next;
     else
 	item->li_prev->li_next = item2->li_next;
-    l->lv_u.mat.lv_idx_item = NULL;
+    list_index_clear(l);
 }
 
 /*
@@ -2012,9 +2153,9 @@ do_sort(list_T *l, sortinfo_T *info)
 	if (!info->item_compare_func_err)
 	{
 	    // Clear the List and append the items in sorted order.
-	    l->lv_first = l->lv_u.mat.lv_last
-		= l->lv_u.mat.lv_idx_item = NULL;
+	    l->lv_first = l->lv_u.mat.lv_last = NULL;
 	    l->lv_len = 0;
+	    list_index_clear(l);
 	    for (i = 0; i < len; ++i)
 		list_append(l, ptrs[i].item);
 	}
@@ -2076,6 +2217,7 @@ do_uniq(list_T *l, sortinfo_T *info)
 	    listitem_free(l, li);
 	    l->lv_len--;
 	}
+	list_index_clear(l);
     }
 
     vim_free(ptrs);
@@ -2351,7 +2493,7 @@ list_filter_map(
 	    l->lv_first = NULL;
 	    l->lv_u.mat.lv_last = NULL;
 	    l->lv_len = 0;
-	    l->lv_u.mat.lv_idx_item = NULL;
+	    list_index_clear(l);
 	}
 
 	for (idx = 0; idx < len; ++idx)
@@ -2921,6 +3063,11 @@ list_reverse(list_T *l, typval_T *rettv)
 	    li = ni;
 	}
 	l->lv_u.mat.lv_idx = l->lv_len - l->lv_u.mat.lv_idx - 1;
+	if (l->lv_index != NULL)
+	{
+	    VIM_CLEAR(l->lv_index);
+	    l->lv_index_len = 0;
+	}
     }
 }
 
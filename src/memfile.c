@@ -69,7 +69,16 @@ static void mf_ins_hash(memfile_T *, bhdr_T *);
 static void mf_rem_hash(memfile_T *, bhdr_T *);
 static bhdr_T *mf_find_hash(memfile_T *, blocknr_T);
 static void mf_ins_used(memfile_T *, bhdr_T *);
+static void mf_ins_cold(memfile_T *, bhdr_T *);
 static void mf_rem_used(memfile_T *, bhdr_T *);
+static void mf_ghost_add(memfile_T *, blocknr_T);
+static int  mf_ghost_rem(memfile_T *, blocknr_T);
+static void mf_zip_add(memfile_T *, bhdr_T *);
+static int  mf_zip_get(memfile_T *, bhdr_T *);
+static void mf_zip_rem(memfile_T *, MF_ZIP *);
+static void mf_zip_clear(memfile_T *);
+static unsigned mf_compress(char_u *, unsigned, char_u *, unsigned);
+static int  mf_uncompress(char_u *, unsigned, char_u *, unsigned);
 static bhdr_T *mf_release(memfile_T *, int);
 static bhdr_T *mf_alloc_bhdr(memfile_T *, int);
 static void mf_free_bhdr(bhdr_T *);
@@ -79,6 +88,10 @@ static int  mf_read(memfile_T *, bhdr_T *);
 static int  mf_write(memfile_T *, bhdr_T *);
 static int  mf_write_block(memfile_T *mfp, bhdr_T *hp, off_T offset, unsigned size);
 static int  mf_trans_add(memfile_T *, bhdr_T *);
+static MF_SRC *mf_src_find(memfile_T *, blocknr_T);
+static MF_SRC *mf_src_block(memfile_T *, bhdr_T *);
+static void mf_src_rem(memfile_T *, blocknr_T);
+static int  mf_read_src(memfile_T *, bhdr_T *, MF_SRC *);
 static void mf_do_open(memfile_T *, char_u *, int);
 static void mf_hash_init(mf_hashtab_T *);
 static void mf_hash_free(mf_hashtab_T *);
@@ -102,6 +115,8 @@ static int mf_hash_grow(mf_hashtab_T *);
  * mf_release_all() release as much memory as possible
  * mf_trans_del()   may translate negative to positive block number
  * mf_fullname()    make file name full path (use before first :cd)
+ * mf_set_source()  set the file that unchanged data blocks can be read from
+ * mf_close_source() stop using that file, get all blocks from it first
  */
 
 /*
@@ -150,10 +165,28 @@ mf_open(char_u *fname, int flags)
     mfp->mf_free_first = NULL;		// free list is empty
     mfp->mf_used_first = NULL;		// used list is empty
     mfp->mf_used_last = NULL;
+    mfp->mf_used_cold = NULL;
     mfp->mf_dirty = FALSE;
+    mfp->mf_need_flush = FALSE;
     mfp->mf_used_count = 0;
+    mfp->mf_hot_count = 0;
+    mfp->mf_hits = 0;
+    mfp->mf_misses = 0;
+    mfp->mf_evictions = 0;
     mf_hash_init(&mfp->mf_hash);
     mf_hash_init(&mfp->mf_trans);
+    mfp->mf_src_fd = -1;
+    mf_hash_init(&mfp->mf_src);
+    mf_hash_init(&mfp->mf_ghost);
+    mfp->mf_ghost_first = NULL;
+    mfp->mf_ghost_last = NULL;
+    mfp->mf_ghost_count = 0;
+    mf_hash_init(&mfp->mf_zip);
+    mfp->mf_zip_first = NULL;
+    mfp->mf_zip_last = NULL;
+    mfp->mf_zip_count = 0;
+    mfp->mf_zip_size = 0;
+    mfp->mf_zip_hits = 0;
     mfp->mf_page_size = MEMFILE_PAGE_SIZE;
 #ifdef FEAT_CRYPT
     mfp->mf_old_key = NULL;
@@ -245,6 +278,8 @@ mf_close(memfile_T *mfp, int del_file)
     }
     if (del_file && mfp->mf_fname != NULL)
 	mch_remove(mfp->mf_fname);
+    if (mfp->mf_src_fd >= 0)
+	close(mfp->mf_src_fd);
 					    // free entries in used list
     for (hp = mfp->mf_used_first; hp != NULL; hp = nextp)
     {
@@ -252,10 +287,14 @@ mf_close(memfile_T *mfp, int del_file)
 	nextp = hp->bh_next;
 	mf_free_bhdr(hp);
     }
+    mf_zip_clear(mfp);
     while (mfp->mf_free_first != NULL)	    // free entries in free list
 	vim_free(mf_rem_free(mfp));
     mf_hash_free(&mfp->mf_hash);
     mf_hash_free_all(&mfp->mf_trans);	    // free hashtable and its items
+    mf_hash_free_all(&mfp->mf_src);
+    mf_hash_free_all(&mfp->mf_ghost);
+    mf_hash_free(&mfp->mf_zip);
     vim_free(mfp->mf_fname);
     vim_free(mfp->mf_ffname);
     vim_free(mfp);
@@ -388,7 +427,7 @@ mf_new(memfile_T *mfp, int negative, int page_count)
     hp->bh_flags = BH_LOCKED | BH_DIRTY;	// new block is always dirty
     mfp->mf_dirty = TRUE;
     hp->bh_page_count = page_count;
-    mf_ins_used(mfp, hp);
+    mf_ins_cold(mfp, hp);
     mf_ins_hash(mfp, hp);
 
     /*
@@ -410,6 +449,7 @@ mf_new(memfile_T *mfp, int negative, int page_count)
 mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
 {
     bhdr_T    *hp;
+    MF_SRC    *msp = NULL;
 						// doesn't exist
     if (nr >= mfp->mf_blocknr_max || nr <= mfp->mf_blocknr_min)
 	return NULL;
@@ -420,8 +460,11 @@ mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
     hp = mf_find_hash(mfp, nr);
     if (hp == NULL)	// not in the hash list
     {
-	if (nr < 0 || nr >= mfp->mf_infile_count)   // can't be in the file
-	    return NULL;
+	// A negative block may be read back from the edited file.
+	if (nr < 0)
+	    msp = mf_src_find(mfp, nr);
+	if (msp == NULL && (nr < 0 || nr >= mfp->mf_infile_count))
+	    return NULL;			    // can't be in the file
 
 	// could check here if the block is in the free list
 
@@ -437,20 +480,40 @@ mf_get(memfile_T *mfp, blocknr_T nr, int page_count)
 	hp->bh_bnum = nr;
 	hp->bh_flags = 0;
 	hp->bh_page_count = page_count;
-	if (mf_read(mfp, hp) == FAIL)	    // cannot read the block!
+	// Like a new block, a block read from the file is not in the swap
+	// file.
+	if (msp != NULL)
+	    hp->bh_flags = BH_DIRTY;
+	if (mf_zip_get(mfp, hp) == OK)
+	    ++mfp->mf_zip_hits;
+	else
 	{
-	    mf_free_bhdr(hp);
-	    return NULL;
+	    if ((msp != NULL ? mf_read_src(mfp, hp, msp)
+					       : mf_read(mfp, hp)) == FAIL)
+	    {
+		mf_free_bhdr(hp);	    // cannot read the block!
+		return NULL;
+	    }
+	    ++mfp->mf_misses;
 	}
+	hp->bh_flags |= BH_LOCKED;
+	// When it was released from the cold part not long ago it is used
+	// again: put in front of used list.  Otherwise put it in front of the
+	// cold part.
+	if (mf_ghost_rem(mfp, nr))
+	    mf_ins_used(mfp, hp);
+	else
+	    mf_ins_cold(mfp, hp);
     }
     else
     {
+	++mfp->mf_hits;
 	mf_rem_used(mfp, hp);	// remove from list, insert in front below
 	mf_rem_hash(mfp, hp);
+	hp->bh_flags |= BH_LOCKED;
+	mf_ins_used(mfp, hp);	// used again: put in front of used list
     }
 
-    hp->bh_flags |= BH_LOCKED;
-    mf_ins_used(mfp, hp);	// put in front of used list
     mf_ins_hash(mfp, hp);	// put in front of hash list
 
     return hp;
@@ -499,6 +562,7 @@ mf_free(memfile_T *mfp, bhdr_T *hp)
     mf_rem_used(mfp, hp);	// get *hp out of the used list
     if (hp->bh_bnum < 0)
     {
+	mf_src_rem(mfp, hp->bh_bnum);
 	vim_free(hp);		// don't want negative numbers in free list
 	mfp->mf_neg_count--;
     }
@@ -576,8 +640,17 @@ mf_sync(memfile_T *mfp, int flags)
     if (hp == NULL || status == FAIL)
 	mfp->mf_dirty = FALSE;
 
-    if ((flags & MFS_FLUSH) && *p_sws != NUL)
+    // Flushing may take a long time, e.g. on a network filesystem.  When
+    // stopped because a character was typed the remaining blocks are written
+    // later, flush them all at once then.  Don't flush when nothing was
+    // written.
+    if ((flags & MFS_FLUSH) && *p_sws != NUL && mfp->mf_need_flush
+					    && !(hp != NULL && (flags & MFS_STOP)))
     {
+	mfp->mf_need_flush = FALSE;
+#ifdef FEAT_EVAL
+	++swap_sync_count;
+#endif
 #if defined(UNIX)
 # ifdef HAVE_FSYNC
 	/*
@@ -704,11 +777,13 @@ mf_find_hash(memfile_T *mfp, blocknr_T nr)
 }
 
 /*
- * insert block *hp in front of used list of memfile *mfp
+ * insert block *hp in front of used list of memfile *mfp, it becomes hot
  */
     static void
 mf_ins_used(memfile_T *mfp, bhdr_T *hp)
 {
+    bhdr_T	*last_hot;
+
     hp->bh_next = mfp->mf_used_first;
     mfp->mf_used_first = hp;
     hp->bh_prev = NULL;
@@ -718,6 +793,53 @@ mf_ins_used(memfile_T *mfp, bhdr_T *hp)
 	hp->bh_next->bh_prev = hp;
     mfp->mf_used_count += hp->bh_page_count;
     total_mem_used += (long_u)hp->bh_page_count * mfp->mf_page_size;
+
+    hp->bh_flags |= BH_HOT;
+    mfp->mf_hot_count += hp->bh_page_count;
+
+    // Keep at least a quarter of the pages in the cold part, so that a block
+    // that is used again soon after it was read can become hot.  The least
+    // recently used hot blocks are moved to the cold part.
+    while (mfp->mf_hot_count > mfp->mf_used_count - mfp->mf_used_count / 4)
+    {
+	last_hot = mfp->mf_used_cold == NULL ? mfp->mf_used_last
+					       : mfp->mf_used_cold->bh_prev;
+	if (last_hot == NULL || last_hot == hp)
+	    break;
+	last_hot->bh_flags &= ~BH_HOT;
+	mfp->mf_hot_count -= last_hot->bh_page_count;
+	mfp->mf_used_cold = last_hot;
+    }
+}
+
+/*
+ * insert block *hp in front of the cold part of the used list of memfile
+ * *mfp
+ */
+    static void
+mf_ins_cold(memfile_T *mfp, bhdr_T *hp)
+{
+    bhdr_T	*cold = mfp->mf_used_cold;
+
+    hp->bh_next = cold;
+    if (cold == NULL)		    // no cold part, append to the list
+    {
+	hp->bh_prev = mfp->mf_used_last;
+	mfp->mf_used_last = hp;
+    }
+    else
+    {
+	hp->bh_prev = cold->bh_prev;
+	cold->bh_prev = hp;
+    }
+    if (hp->bh_prev == NULL)	    // first block in used list
+	mfp->mf_used_first = hp;
+    else
+	hp->bh_prev->bh_next = hp;
+    mfp->mf_used_cold = hp;
+    hp->bh_flags &= ~BH_HOT;
+    mfp->mf_used_count += hp->bh_page_count;
+    total_mem_used += (long_u)hp->bh_page_count * mfp->mf_page_size;
 }
 
 /*
@@ -726,6 +848,10 @@ mf_ins_used(memfile_T *mfp, bhdr_T *hp)
     static void
 mf_rem_used(memfile_T *mfp, bhdr_T *hp)
 {
+    if (hp == mfp->mf_used_cold)
+	mfp->mf_used_cold = hp->bh_next;
+    if (hp->bh_flags & BH_HOT)
+	mfp->mf_hot_count -= hp->bh_page_count;
     if (hp->bh_next == NULL)	    // last block in used list
 	mfp->mf_used_last = hp->bh_prev;
     else
@@ -738,6 +864,332 @@ mf_rem_used(memfile_T *mfp, bhdr_T *hp)
     total_mem_used -= (long_u)hp->bh_page_count * mfp->mf_page_size;
 }
 
+/*
+ * Remember block "nr" in the ghost list of memfile *mfp.  The oldest item is
+ * dropped when the list holds half of the maximum number of pages.
+ */
+    static void
+mf_ghost_add(memfile_T *mfp, blocknr_T nr)
+{
+    MF_GHOST	*mgp;
+
+    if (mf_hash_find(&mfp->mf_ghost, nr) != NULL)
+	return;
+    if (mfp->mf_ghost_count >= mfp->mf_used_count_max / 2
+					       && mfp->mf_ghost_first != NULL)
+    {
+	// re-use the oldest item
+	mgp = mfp->mf_ghost_first;
+	mfp->mf_ghost_first = mgp->mg_next;
+	if (mfp->mf_ghost_first == NULL)
+	    mfp->mf_ghost_last = NULL;
+	else
+	    mfp->mf_ghost_first->mg_prev = NULL;
+	mf_hash_rem_item(&mfp->mf_ghost, (mf_hashitem_T *)mgp);
+	--mfp->mf_ghost_count;
+    }
+    else if ((mgp = ALLOC_ONE(MF_GHOST)) == NULL)
+	return;
+
+    mgp->mg_bnum = nr;
+    mgp->mg_next = NULL;
+    mgp->mg_prev = mfp->mf_ghost_last;
+    if (mfp->mf_ghost_last == NULL)
+	mfp->mf_ghost_first = mgp;
+    else
+	mfp->mf_ghost_last->mg_next = mgp;
+    mfp->mf_ghost_last = mgp;
+    mf_hash_add_item(&mfp->mf_ghost, (mf_hashitem_T *)mgp);
+    ++mfp->mf_ghost_count;
+}
+
+/*
+ * Remove block "nr" from the ghost list of memfile *mfp.
+ * Return TRUE if it was there.
+ */
+    static int
+mf_ghost_rem(memfile_T *mfp, blocknr_T nr)
+{
+    MF_GHOST	*mgp;
+
+    mgp = (MF_GHOST *)mf_hash_find(&mfp->mf_ghost, nr);
+    if (mgp == NULL)
+	return FALSE;
+    if (mgp->mg_prev == NULL)
+	mfp->mf_ghost_first = mgp->mg_next;
+    else
+	mgp->mg_prev->mg_next = mgp->mg_next;
+    if (mgp->mg_next == NULL)
+	mfp->mf_ghost_last = mgp->mg_prev;
+    else
+	mgp->mg_next->mg_prev = mgp->mg_prev;
+    mf_hash_rem_item(&mfp->mf_ghost, (mf_hashitem_T *)mgp);
+    vim_free(mgp);
+    --mfp->mf_ghost_count;
+    return TRUE;
+}
+
+/*
+ * Keep a compressed copy of block *hp, which is being released from memory.
+ * The copy is only kept when it is at most three quarters of the size.  The
+ * compressed blocks of a memfile use at most a quarter of 'maxmem', the
+ * oldest ones are dropped to make room.
+ */
+    static void
+mf_zip_add(memfile_T *mfp, bhdr_T *hp)
+{
+    unsigned	size = mfp->mf_page_size * hp->bh_page_count;
+    unsigned	maxlen = size - size / 4;
+    long_u	limit = (long_u)mfp->mf_used_count_max * mfp->mf_page_size / 4;
+    char_u	*buf;
+    unsigned	len;
+    MF_ZIP	*mzp;
+
+    if (maxlen > limit || (buf = alloc(maxlen)) == NULL)
+	return;
+    len = mf_compress(hp->bh_data, size, buf, maxlen);
+    if (len > 0)
+    {
+	while (mfp->mf_zip_first != NULL && (mfp->mf_zip_size + len > limit
+			   || ((total_mem_used + len) >> 10) >= (long_u)p_mmt))
+	    mf_zip_rem(mfp, mfp->mf_zip_first);
+	if (((total_mem_used + len) >> 10) < (long_u)p_mmt
+		&& (mzp = alloc(offsetof(MF_ZIP, mz_data) + len)) != NULL)
+	{
+	    mzp->mz_bnum = hp->bh_bnum;
+	    mzp->mz_page_count = hp->bh_page_count;
+	    mzp->mz_size = len;
+	    mch_memmove(mzp->mz_data, buf, len);
+	    mzp->mz_next = NULL;
+	    mzp->mz_prev = mfp->mf_zip_last;
+	    if (mfp->mf_zip_last == NULL)
+		mfp->mf_zip_first = mzp;
+	    else
+		mfp->mf_zip_last->mz_next = mzp;
+	    mfp->mf_zip_last = mzp;
+	    mf_hash_add_item(&mfp->mf_zip, (mf_hashitem_T *)mzp);
+	    ++mfp->mf_zip_count;
+	    mfp->mf_zip_size += len;
+	    total_mem_used += len;
+	}
+    }
+    vim_free(buf);
+}
+
+/*
+ * Fill the data of block *hp from its compressed copy, if there is one.  The
+ * copy is removed, the block in memory is used from now on.
+ * Return FAIL if there is no compressed copy.
+ */
+    static int
+mf_zip_get(memfile_T *mfp, bhdr_T *hp)
+{
+    MF_ZIP	*mzp;
+    int		retval = FAIL;
+
+    mzp = (MF_ZIP *)mf_hash_find(&mfp->mf_zip, hp->bh_bnum);
+    if (mzp == NULL)
+	return FAIL;
+    if (mzp->mz_page_count == hp->bh_page_count)
+	retval = mf_uncompress(mzp->mz_data, mzp->mz_size, hp->bh_data,
+				  mfp->mf_page_size * hp->bh_page_count);
+    mf_zip_rem(mfp, mzp);
+    return retval;
+}
+
+/*
+ * Remove compressed block *mzp from memfile *mfp and free it.
+ */
+    static void
+mf_zip_rem(memfile_T *mfp, MF_ZIP *mzp)
+{
+    if (mzp->mz_prev == NULL)
+	mfp->mf_zip_first = mzp->mz_next;
+    else
+	mzp->mz_prev->mz_next = mzp->mz_next;
+    if (mzp->mz_next == NULL)
+	mfp->mf_zip_last = mzp->mz_prev;
+    else
+	mzp->mz_next->mz_prev = mzp->mz_prev;
+    mf_hash_rem_item(&mfp->mf_zip, (mf_hashitem_T *)mzp);
+    --mfp->mf_zip_count;
+    mfp->mf_zip_size -= mzp->mz_size;
+    total_mem_used -= mzp->mz_size;
+    vim_free(mzp);
+}
+
+/*
+ * Free all compressed blocks of memfile *mfp.
+ */
+    static void
+mf_zip_clear(memfile_T *mfp)
+{
+    while (mfp->mf_zip_first != NULL)
+	mf_zip_rem(mfp, mfp->mf_zip_first);
+}
+
+/*
+ * Simple LZ77 compression, using the same format as LZ4 blocks: Each sequence
+ * starts with a byte holding the number of literal bytes in the upper four
+ * bits and the match length minus MF_MIN_MATCH in the lower four bits.  A
+ * value of 15 means more length bytes follow, each adds up to 255.  The
+ * literal bytes follow, then the two byte match offset, least significant
+ * byte first.  The last sequence only has literal bytes.
+ */
+#define MF_MIN_MATCH	4
+#define MF_ZIP_HASH_BITS 12
+
+/*
+ * Store length "len" of a sequence, the part that did not fit in the first
+ * byte, at "dst[*op]".
+ */
+    static void
+mf_zip_length(char_u *dst, unsigned *op, unsigned len)
+{
+    for ( ; len >= 255; len -= 255)
+	dst[(*op)++] = 255;
+    dst[(*op)++] = len;
+}
+
+/*
+ * Store a sequence of "lit_len" literal bytes at "lit", followed by a match
+ * of "match_len" bytes "offset" bytes back, at "dst[*op]".  When "match_len"
+ * is zero it is the last sequence.
+ * Return FAIL when it does not fit in "maxlen" bytes.
+ */
+    static int
+mf_zip_sequence(
+    char_u	*dst,
+    unsigned	*op,
+    unsigned	maxlen,
+    char_u	*lit,
+    unsigned	lit_len,
+    unsigned	offset,
+    unsigned	match_len)
+{
+    unsigned	n = match_len == 0 ? 0 : match_len - MF_MIN_MATCH;
+
+    if (*op + lit_len + lit_len / 255 + n / 255 + 5 > maxlen)
+	return FAIL;
+    dst[(*op)++] = ((lit_len < 15 ? lit_len : 15) << 4) | (n < 15 ? n : 15);
+    if (lit_len >= 15)
+	mf_zip_length(dst, op, lit_len - 15);
+    mch_memmove(dst + *op, lit, lit_len);
+    *op += lit_len;
+    if (match_len > 0)
+    {
+	dst[(*op)++] = offset & 0xff;
+	dst[(*op)++] = offset >> 8;
+	if (n >= 15)
+	    mf_zip_length(dst, op, n - 15);
+    }
+    return OK;
+}
+
+/*
+ * Compress "len" bytes at "src" into "dst".
+ * Return the compressed size, zero when it does not fit in "maxlen" bytes.
+ */
+    static unsigned
+mf_compress(char_u *src, unsigned len, char_u *dst, unsigned maxlen)
+{
+    int		table[1 << MF_ZIP_HASH_BITS];
+    unsigned	ip = 0;
+    unsigned	anchor = 0;
+    unsigned	op = 0;
+    unsigned	h;
+    unsigned	mlen;
+    int		ref;
+
+    for (h = 0; h < (1 << MF_ZIP_HASH_BITS); ++h)
+	table[h] = -1;
+    while (ip + MF_MIN_MATCH <= len)
+    {
+	h = (((UINT32_T)src[ip] | ((UINT32_T)src[ip + 1] << 8)
+		    | ((UINT32_T)src[ip + 2] << 16)
+		    | ((UINT32_T)src[ip + 3] << 24)) * 2654435761U)
+			     >> (32 - MF_ZIP_HASH_BITS)
+						& ((1 << MF_ZIP_HASH_BITS) - 1);
+	ref = table[h];
+	table[h] = (int)ip;
+	if (ref < 0 || ip - ref > 0xffff
+		     || memcmp(src + ref, src + ip, MF_MIN_MATCH) != 0)
+	{
+	    ++ip;
+	    continue;
+	}
+	mlen = MF_MIN_MATCH;
+	while (ip + mlen < len && src[ref + mlen] == src[ip + mlen])
+	    ++mlen;
+	if (mf_zip_sequence(dst, &op, maxlen, src + anchor, ip - anchor,
+						    ip - ref, mlen) == FAIL)
+	    return 0;
+	ip += mlen;
+	anchor = ip;
+    }
+    if (mf_zip_sequence(dst, &op, maxlen, src + anchor, len - anchor, 0, 0)
+								       == FAIL)
+	return 0;
+    return op;
+}
+
+/*
+ * Uncompress "len" bytes at "src" into "dstlen" bytes at "dst".
+ * Return FAIL when the data is invalid.
+ */
+    static int
+mf_uncompress(char_u *src, unsigned len, char_u *dst, unsigned dstlen)
+{
+    unsigned	ip = 0;
+    unsigned	op = 0;
+    unsigned	n;
+    unsigned	offset;
+    int		token;
+    int		c;
+
+    while (ip < len)
+    {
+	token = src[ip++];
+	n = token >> 4;
+	if (n == 15)
+	    do
+	    {
+		if (ip >= len)
+		    return FAIL;
+		c = src[ip++];
+		n += c;
+	    } while (c == 255);
+	if (n > len - ip || n > dstlen - op)
+	    return FAIL;
+	mch_memmove(dst + op, src + ip, n);
+	ip += n;
+	op += n;
+	if (ip == len)
+	    break;
+
+	if (ip + 2 > len)
+	    return FAIL;
+	offset = src[ip] | (src[ip + 1] << 8);
+	ip += 2;
+	n = token & 15;
+	if (n == 15)
+	    do
+	    {
+		if (ip >= len)
+		    return FAIL;
+		c = src[ip++];
+		n += c;
+	    } while (c == 255);
+	n += MF_MIN_MATCH;
+	if (offset == 0 || offset > op || n > dstlen - op)
+	    return FAIL;
+	// the match may overlap with the bytes being produced
+	for ( ; n > 0; --n, ++op)
+	    dst[op] = dst[op - offset];
+    }
+    return op == dstlen ? OK : FAIL;
+}
+
 /*
  * Release the least recently used block from the used list if the number
  * of used memory blocks gets to big.
@@ -758,6 +1210,12 @@ mf_release(memfile_T *mfp, int page_count)
     if (mf_dont_release)
 	return NULL;
 
+    // Compressed blocks go first when total memory used is over
+    // 'maxmemtot'.
+    while ((total_mem_used >> 10) >= (long_u)p_mmt
+						 && mfp->mf_zip_first != NULL)
+	mf_zip_rem(mfp, mfp->mf_zip_first);
+
     /*
      * Need to release a block if the number of blocks for this memfile is
      * higher than the maximum or total memory used is over 'maxmemtot'
@@ -781,30 +1239,38 @@ mf_release(memfile_T *mfp, int page_count)
 
     /*
      * don't release a block if
-     *	there is no file for this memfile
+     *	there is no file for this memfile and no file that blocks can be
+     *	read back from
      * or
      *	the number of blocks for this memfile is lower than the maximum
      *	  and
      *	total memory used is not up to 'maxmemtot'
      */
-    if (mfp->mf_fd < 0 || !need_release)
+    if ((mfp->mf_fd < 0 && mfp->mf_src_fd < 0) || !need_release)
 	return NULL;
 
     for (hp = mfp->mf_used_last; hp != NULL; hp = hp->bh_prev)
-	if (!(hp->bh_flags & BH_LOCKED))
+	if (!(hp->bh_flags & BH_LOCKED)
+		&& (mfp->mf_fd >= 0 || mf_src_block(mfp, hp) != NULL))
 	    break;
     if (hp == NULL)	// not a single one that can be released
 	return NULL;
 
     /*
-     * If the block is dirty, write it.
+     * If the block is dirty, write it, unless it can be read back from the
+     * edited file.
      * If the write fails we don't free it.
      */
-    if ((hp->bh_flags & BH_DIRTY) && mf_write(mfp, hp) == FAIL)
+    if ((hp->bh_flags & BH_DIRTY) && mf_src_block(mfp, hp) == NULL
+						 && mf_write(mfp, hp) == FAIL)
 	return NULL;
 
     mf_rem_used(mfp, hp);
     mf_rem_hash(mfp, hp);
+    ++mfp->mf_evictions;
+    if (!(hp->bh_flags & BH_HOT))
+	mf_ghost_add(mfp, hp->bh_bnum);
+    mf_zip_add(mfp, hp);
 
     /*
      * If a bhdr_T is returned, make sure that the page_count of bh_data is
@@ -843,22 +1309,31 @@ mf_release_all(void)
 	mfp = buf->b_ml.ml_mfp;
 	if (mfp != NULL)
 	{
+	    if (mfp->mf_zip_first != NULL)
+	    {
+		mf_zip_clear(mfp);
+		retval = TRUE;
+	    }
+
 	    // If no swap file yet, may open one
 	    if (mfp->mf_fd < 0 && buf->b_may_swap)
 		ml_open_file(buf);
 
-	    // only if there is a swapfile
-	    if (mfp->mf_fd >= 0)
+	    // only if there is a swapfile or a file to read blocks from
+	    if (mfp->mf_fd >= 0 || mfp->mf_src_fd >= 0)
 	    {
 		for (hp = mfp->mf_used_last; hp != NULL; )
 		{
 		    if (!(hp->bh_flags & BH_LOCKED)
-			    && (!(hp->bh_flags & BH_DIRTY)
-				|| mf_write(mfp, hp) != FAIL))
+			    && (mf_src_block(mfp, hp) != NULL
+				|| (mfp->mf_fd >= 0
+				    && (!(hp->bh_flags & BH_DIRTY)
+					|| mf_write(mfp, hp) != FAIL))))
 		    {
 			mf_rem_used(mfp, hp);
 			mf_rem_hash(mfp, hp);
 			mf_free_bhdr(hp);
+			++mfp->mf_evictions;
 			hp = mfp->mf_used_last;	// re-start, list was changed
 			retval = TRUE;
 		    }
@@ -1054,6 +1529,7 @@ mf_write(memfile_T *mfp, bhdr_T *hp)
 	}
 
 	did_swapwrite_msg = FALSE;
+	mfp->mf_need_flush = TRUE;
 	if (hp2 != NULL)		    // written a non-dummy block
 	    hp2->bh_flags &= ~BH_DIRTY;
 					    // appended to the file
@@ -1154,6 +1630,9 @@ mf_trans_add(memfile_T *mfp, bhdr_T *hp)
     np->nt_old_bnum = hp->bh_bnum;	    // adjust number
     np->nt_new_bnum = new_bnum;
 
+    // The block will be in the swap file, don't read it from the edited file.
+    mf_src_rem(mfp, hp->bh_bnum);
+
     mf_rem_hash(mfp, hp);		    // remove from old hash list
     hp->bh_bnum = new_bnum;
     mf_ins_hash(mfp, hp);		    // insert in new hash list
@@ -1191,6 +1670,189 @@ mf_trans_del(memfile_T *mfp, blocknr_T old_nr)
     return new_bnum;
 }
 
+/*
+ * Use file descriptor "fd" for reading data blocks that were filled when
+ * reading the edited file and were not changed since then.  It is closed when
+ * the memfile is closed.
+ * When blocks are still read from another file "fd" is closed and FAIL is
+ * returned.
+ */
+    int
+mf_set_source(memfile_T *mfp, int fd)
+{
+    if (mfp->mf_src.mht_count > 0)
+    {
+	close(fd);
+	return FAIL;
+    }
+    if (mfp->mf_src_fd >= 0)
+	close(mfp->mf_src_fd);
+    mfp->mf_src_fd = fd;
+    return OK;
+}
+
+/*
+ * Called when a line of "len" bytes was appended to data block "hp" at index
+ * "idx" while reading the edited file.  "offset" is where the line starts in
+ * the file, -1 when the text in the block differs from the file.
+ */
+    void
+mf_src_append(
+    memfile_T	*mfp,
+    bhdr_T	*hp,
+    int		idx,
+    off_T	offset,
+    long	len)
+{
+    MF_SRC	*msp;
+
+    if (mfp->mf_src_fd < 0 || hp->bh_bnum >= 0)
+	return;
+
+    msp = mf_src_find(mfp, hp->bh_bnum);
+    if (offset < 0)
+    {
+	if (msp != NULL)
+	    mf_src_rem(mfp, hp->bh_bnum);
+	return;
+    }
+    if (msp == NULL)
+    {
+	// Only a block that starts with this line can be read from the file.
+	if (idx != 0 || (msp = ALLOC_ONE(MF_SRC)) == NULL)
+	    return;
+	msp->ms_bnum = hp->bh_bnum;
+	msp->ms_offset = offset;
+	msp->ms_len = 0;
+	msp->ms_line_count = 0;
+	mf_hash_add_item(&mfp->mf_src, (mf_hashitem_T *)msp);
+    }
+    else if (idx != msp->ms_line_count
+				   || offset != msp->ms_offset + msp->ms_len)
+    {
+	// Not the line following the text in the block.
+	mf_src_rem(mfp, hp->bh_bnum);
+	return;
+    }
+    msp->ms_len += len;
+    ++msp->ms_line_count;
+    msp->ms_page_count = hp->bh_page_count;
+}
+
+/*
+ * Data block "hp" was changed without changing the number of lines, don't
+ * read it from the edited file.
+ */
+    void
+mf_src_forget(memfile_T *mfp, bhdr_T *hp)
+{
+    if (mfp->mf_src_fd >= 0 && hp->bh_bnum < 0)
+	mf_src_rem(mfp, hp->bh_bnum);
+}
+
+/*
+ * Get all blocks that can be read from the edited file and give them a place
+ * in the swap file, then close the edited file.  Used before the edited file
+ * is overwritten.
+ * The caller must make sure no data block is locked.
+ */
+    void
+mf_close_source(memfile_T *mfp)
+{
+    long_u	idx;
+    MF_SRC	*msp;
+    bhdr_T	*hp;
+    blocknr_T	nr;
+
+    if (mfp->mf_src_fd < 0)
+	return;
+
+    for (idx = 0; idx <= mfp->mf_src.mht_mask; ++idx)
+	while ((msp = (MF_SRC *)mfp->mf_src.mht_buckets[idx]) != NULL)
+	{
+	    nr = msp->ms_bnum;
+	    hp = mf_get(mfp, nr, msp->ms_page_count);
+	    if (hp != NULL)
+		mf_put(mfp, hp, TRUE, TRUE);   // removes the entry
+	    // When reading the block failed the text is lost.
+	    mf_src_rem(mfp, nr);
+	}
+
+    close(mfp->mf_src_fd);
+    mfp->mf_src_fd = -1;
+}
+
+/*
+ * Find the entry for block "nr" in the list of blocks that can be read from
+ * the edited file.
+ */
+    static MF_SRC *
+mf_src_find(memfile_T *mfp, blocknr_T nr)
+{
+    if (mfp->mf_src_fd < 0)
+	return NULL;
+    return (MF_SRC *)mf_hash_find(&mfp->mf_src, nr);
+}
+
+/*
+ * Return the entry for block "hp" when it can be read back from the edited
+ * file, NULL otherwise.  When a line was added for another reason it can't.
+ */
+    static MF_SRC *
+mf_src_block(memfile_T *mfp, bhdr_T *hp)
+{
+    MF_SRC	*msp = mf_src_find(mfp, hp->bh_bnum);
+
+    if (msp != NULL && ml_data_line_count(hp->bh_data) != msp->ms_line_count)
+	return NULL;
+    return msp;
+}
+
+/*
+ * Remove the entry for block "nr" from the list of blocks that can be read
+ * from the edited file, if there is one.
+ */
+    static void
+mf_src_rem(memfile_T *mfp, blocknr_T nr)
+{
+    MF_SRC	*msp;
+
+    msp = (MF_SRC *)mf_hash_find(&mfp->mf_src, nr);
+    if (msp != NULL)
+    {
+	mf_hash_rem_item(&mfp->mf_src, (mf_hashitem_T *)msp);
+	vim_free(msp);
+    }
+}
+
+/*
+ * Read block "hp" from the edited file, using the position in "msp".
+ *
+ * Return FAIL for failure, OK otherwise
+ */
+    static int
+mf_read_src(memfile_T *mfp, bhdr_T *hp, MF_SRC *msp)
+{
+    char_u	*text;
+    int		retval = FAIL;
+
+    if (hp->bh_page_count == msp->ms_page_count
+				     && (text = alloc(msp->ms_len)) != NULL)
+    {
+	if (vim_lseek(mfp->mf_src_fd, msp->ms_offset, SEEK_SET)
+							     == msp->ms_offset
+		&& read_eintr(mfp->mf_src_fd, text, msp->ms_len)
+								== msp->ms_len)
+	    retval = ml_fill_data_block(hp->bh_data,
+				   mfp->mf_page_size * hp->bh_page_count,
+				   text, msp->ms_len, msp->ms_line_count);
+	vim_free(text);
+    }
+    if (retval == FAIL)
+	emsg(_(e_cannot_read_block_from_original_file));
+    return retval;
+}
+
 /*
  * Set mfp->mf_ffname according to mfp->mf_fname and some other things.
  * Only called when creating or renaming the swapfile.	Either way it's a new
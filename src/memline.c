@@ -248,6 +248,7 @@ static int recov_file_names(char_u **, char_u *, int prepend_dot);
 static char_u *findswapname(buf_T *, char_u **, char_u *);
 static void ml_flush_line(buf_T *);
 static bhdr_T *ml_new_data(memfile_T *, int, int);
+static void ml_src_append(buf_T *, bhdr_T *, int, colnr_T, int);
 static bhdr_T *ml_new_ptr(memfile_T *);
 static bhdr_T *ml_find_line(buf_T *, linenr_T, int);
 static int ml_add_stack(buf_T *);
@@ -263,6 +264,7 @@ static cryptstate_T *ml_crypt_prepare(memfile_T *mfp, off_T offset, int reading)
 #endif
 #ifdef FEAT_BYTEOFF
 static void ml_updatechunk(buf_T *buf, long line, long len, int updtype);
+static void ml_chunk_split_lines(buf_T *buf, linenr_T first, linenr_T last);
 #endif
 
 /*
@@ -287,6 +289,7 @@ ml_open(buf_T *buf)
     buf->b_ml.ml_stack_top = 0;	// nothing in the stack
     buf->b_ml.ml_locked = NULL;	// no cached block
     buf->b_ml.ml_line_lnum = 0;	// no cached line
+    buf->b_ml.ml_src_off = -1;	// not reading a file
 #ifdef FEAT_BYTEOFF
     buf->b_ml.ml_chunksize = NULL;
     buf->b_ml.ml_usedchunks = 0;
@@ -2424,6 +2427,7 @@ ml_sync_all(int check_file, int check_char)
 {
     buf_T		*buf;
     stat_T		st;
+    int			flush;
 
     FOR_ALL_BUFFERS(buf)
     {
@@ -2454,10 +2458,16 @@ ml_sync_all(int check_file, int check_char)
 		need_check_timestamps = TRUE;	// give message later
 	    }
 	}
-	if (buf->b_ml.ml_mfp->mf_dirty)
+	// When syncing because 'updatecount' was reached while typing only
+	// write the blocks, flushing them to disk is done when waiting for a
+	// character for 'updatetime' msec.  Flushing can be slow and would
+	// make typing sluggish.
+	flush = bufIsChanged(buf) && (check_file || !check_char);
+	if (buf->b_ml.ml_mfp->mf_dirty
+			       || (flush && buf->b_ml.ml_mfp->mf_need_flush))
 	{
 	    (void)mf_sync(buf->b_ml.ml_mfp, (check_char ? MFS_STOP : 0)
-					| (bufIsChanged(buf) ? MFS_FLUSH : 0));
+						  | (flush ? MFS_FLUSH : 0));
 	    if (check_char && ui_char_avail())	// character available now
 		break;
 	}
@@ -2496,6 +2506,9 @@ ml_preserve(buf_T *buf, int message)
 
     ml_flush_line(buf);				    // flush buffered line
     (void)ml_find_line(buf, (linenr_T)0, ML_FLUSH); // flush locked block
+    // Blocks that would be read from the original file must be in the swap
+    // file too.
+    mf_close_source(mfp);
     status = mf_sync(mfp, MFS_ALL | MFS_FLUSH);
 
     // stack is invalid after mf_sync(.., MFS_ALL)
@@ -2909,6 +2922,7 @@ ml_append_int(
 	mch_memmove((char *)dp + dp->db_index[db_idx + 1], line, (size_t)len);
 	if (flags & ML_APPEND_MARK)
 	    dp->db_index[db_idx + 1] |= DB_MARKED;
+	ml_src_append(buf, hp, db_idx + 1, line == line_arg ? len : 0, flags);
 
 	/*
 	 * Mark the block dirty.
@@ -3025,6 +3039,7 @@ ml_append_int(
 
 	    mch_memmove((char *)dp_right + dp_right->db_txt_start,
 							   line, (size_t)len);
+	    ml_src_append(buf, hp_right, 0, line == line_arg ? len : 0, flags);
 	    ++line_count_right;
 	}
 	/*
@@ -3065,6 +3080,8 @@ ml_append_int(
 		dp_left->db_index[line_count_left] |= DB_MARKED;
 	    mch_memmove((char *)dp_left + dp_left->db_txt_start,
 							   line, (size_t)len);
+	    ml_src_append(buf, hp_left, line_count_left,
+				       line == line_arg ? len : 0, flags);
 	    ++line_count_left;
 	}
 
@@ -3360,6 +3377,190 @@ ml_append_flags(
     return ml_append_flush(curbuf, lnum, line, len, flags);
 }
 
+/*
+ * Insert as many of the "count" lines in "lines" as fit in the data block
+ * that contains line "lnum", after line "lnum" (can be 0).
+ * The text of the lines that follow is moved only once.
+ * Returns the number of lines inserted, zero when not even the first line
+ * fits or something went wrong.
+ */
+    static long
+ml_append_fill(
+    buf_T	*buf,
+    linenr_T	lnum,		// append after this line (can be 0)
+    char_u	**lines,	// text of the new lines
+    long	count,		// number of lines in "lines"
+    int		flags)		// ML_APPEND_ flags
+{
+    bhdr_T	*hp;
+    DATA_BL	*dp;
+    int		db_idx;		// index for lnum in data block
+    int		line_count;	// number of indexes in current block
+    int		offset;
+    int		room;
+    int		total_len = 0;
+    long	n;
+    int		i;
+    colnr_T	len;
+
+    if ((hp = ml_find_line(buf, lnum == 0 ? (linenr_T)1 : lnum, ML_FIND))
+								       == NULL)
+	return 0;
+    dp = (DATA_BL *)(hp->bh_data);
+
+    // Find out how many lines fit in the free space.
+    room = (int)dp->db_free;
+    for (n = 0; n < count; ++n)
+    {
+	len = (colnr_T)STRLEN(lines[n]) + 1;
+	if (len + (int)INDEX_SIZE > room)
+	    break;
+	room -= len + INDEX_SIZE;
+	total_len += len;
+    }
+    if (n == 0)
+	return 0;
+
+    if (lnum == 0)
+	db_idx = -1;		// careful, it is negative!
+    else
+	db_idx = lnum - buf->b_ml.ml_locked_low;
+    line_count = buf->b_ml.ml_locked_high - buf->b_ml.ml_locked_low + 1;
+
+    // Offset is the start of the previous line, the text of the new lines
+    // goes just before it.
+    if (db_idx < 0)
+	offset = dp->db_txt_end;
+    else
+	offset = ((dp->db_index[db_idx]) & DB_INDEX_MASK);
+
+    dp->db_txt_start -= total_len;
+    dp->db_free = room;
+    dp->db_line_count += n;
+
+    // Move the text of the lines that follow to the front once and adjust
+    // their indexes.
+    if (line_count > db_idx + 1)
+    {
+	mch_memmove((char *)dp + dp->db_txt_start,
+				     (char *)dp + dp->db_txt_start + total_len,
+			     (size_t)(offset - (dp->db_txt_start + total_len)));
+	for (i = line_count - 1; i > db_idx; --i)
+	    dp->db_index[i + n] = dp->db_index[i] - total_len;
+    }
+
+    for (i = 0; i < n; ++i)
+    {
+	len = (colnr_T)STRLEN(lines[i]) + 1;
+	offset -= len;
+	mch_memmove((char *)dp + offset, lines[i], (size_t)len);
+	dp->db_index[db_idx + 1 + i] = offset;
+	if (flags & ML_APPEND_MARK)
+	    dp->db_index[db_idx + 1 + i] |= DB_MARKED;
+    }
+    ml_src_append(buf, hp, db_idx + 1, 0, 0);
+
+    buf->b_ml.ml_flags |= ML_LOCKED_DIRTY | ML_LOCKED_POS;
+    buf->b_ml.ml_flags &= ~ML_EMPTY;
+    buf->b_ml.ml_locked_lineadd += n;
+    buf->b_ml.ml_locked_high += n;
+    buf->b_ml.ml_line_count += n;
+
+    for (i = 0; i < n; ++i)
+    {
+#ifdef FEAT_BYTEOFF
+	// Splitting a chunk looks at the text, which must match the lines
+	// counted so far.  Split when all lines were counted.
+	ml_updatechunk(buf, lnum + 1 + i, (long)STRLEN(lines[i]) + 1,
+						     ML_CHNK_ADDLINE_NOSPLIT);
+#endif
+#ifdef FEAT_NETBEANS_INTG
+	if (netbeans_active())
+	{
+	    len = (colnr_T)STRLEN(lines[i]);
+	    if (len > 0)
+		netbeans_inserted(buf, lnum + 1 + i, (colnr_T)0, lines[i], len);
+	    netbeans_inserted(buf, lnum + 1 + i, len, (char_u *)"\n", 1);
+	}
+#endif
+    }
+#ifdef FEAT_BYTEOFF
+    ml_chunk_split_lines(buf, lnum + 1, lnum + n);
+#endif
+    return n;
+}
+
+/*
+ * Append "count" lines from "lines" after line "lnum" (may be 0) in the
+ * current buffer.  This is like calling ml_append_flags() for each line, but
+ * lines are inserted into a data block at once, as many as fit.  Useful when
+ * inserting many lines at one position.
+ * "flags" can be ML_APPEND_MARK.
+ *
+ * Check: The caller of this function should probably also call
+ * appended_lines().
+ *
+ * return FAIL for failure, OK otherwise
+ */
+    int
+ml_append_bulk(
+    linenr_T	lnum,		// append after this line (can be 0)
+    char_u	**lines,	// text of the new lines
+    long	count,		// number of lines
+    int		flags)		// ML_APPEND_ values
+{
+    buf_T	*buf = curbuf;
+    long	done = 0;
+    long	n;
+
+    // When starting up, we might still need to create the memfile
+    if (buf->b_ml.ml_mfp == NULL && open_buffer(FALSE, NULL, 0) == FAIL)
+	return FAIL;
+    if (lnum > buf->b_ml.ml_line_count)
+	return FAIL;  // lnum out of range
+    if (count <= 0)
+	return OK;
+
+    if (buf->b_ml.ml_line_lnum != 0)
+	ml_flush_line(buf);
+#ifdef FEAT_EVAL
+    may_invoke_listeners(buf, lnum + 1, lnum + 1, count);
+    if (buf->b_ml.ml_line_lnum != 0)
+	ml_flush_line(buf);
+#endif
+
+    if (lowest_marked && lowest_marked > lnum)
+	lowest_marked = lnum + 1;
+
+    while (done < count)
+    {
+	n = 0;
+#ifdef FEAT_PROP_POPUP
+	// Text properties continuing from the previous line are added by
+	// ml_append_int().
+	if (!curbuf->b_has_textprop || lnum == 0
+					       || (flags & ML_APPEND_NOPROP))
+#endif
+	    n = ml_append_fill(buf, lnum, lines + done, count - done, flags);
+	if (n == 0)
+	{
+	    // Does not fit in the block, ml_append_int() splits it.
+	    if (ml_append_int(buf, lnum, lines[done], (colnr_T)0, flags)
+								       == FAIL)
+		return FAIL;
+	    n = 1;
+	}
+	lnum += n;
+	done += n;
+    }
+
+#ifdef FEAT_JOB_CHANNEL
+    if (buf->b_write_to_channel)
+	channel_write_new_lines(buf);
+#endif
+    return OK;
+}
+
 
 #if defined(FEAT_SPELL) || defined(FEAT_QUICKFIX) || defined(PROTO)
 /*
@@ -3858,6 +4059,8 @@ ml_setmarked(linenr_T lnum)
     dp = (DATA_BL *)(hp->bh_data);
     dp->db_index[lnum - curbuf->b_ml.ml_locked_low] |= DB_MARKED;
     curbuf->b_ml.ml_flags |= ML_LOCKED_DIRTY;
+    // The mark would be lost when reading the block from the file.
+    mf_src_forget(curbuf->b_ml.ml_mfp, hp);
 }
 
 /*
@@ -4089,6 +4292,94 @@ ml_new_data(memfile_T *mfp, int negative, int page_count)
     return hp;
 }
 
+/*
+ * Remember where the text of a line that was appended at index "idx" in data
+ * block "hp" can be found in the edited file.  "len" is the length of the
+ * line including the NUL, zero when it's not the text from the file.
+ */
+    static void
+ml_src_append(buf_T *buf, bhdr_T *hp, int idx, colnr_T len, int flags)
+{
+    off_T	offset = -1;
+
+    if (buf->b_ml.ml_mfp->mf_src_fd < 0)
+	return;
+    // The NUL takes the place of the NL in the file.
+    if ((flags & ML_APPEND_NEW) && len > 0)
+	offset = buf->b_ml.ml_src_off;
+    mf_src_append(buf->b_ml.ml_mfp, hp, idx, offset, (long)len);
+}
+
+/*
+ * Fill data block "data" of "size" bytes with "line_count" lines from "text",
+ * which are "len" bytes read from the edited file.  Each line must end in a
+ * NL.  Like when reading the file a NUL is stored as a NL.
+ *
+ * Return FAIL when the text doesn't have the expected lines.
+ */
+    int
+ml_fill_data_block(
+    char_u	*data,
+    unsigned	size,
+    char_u	*text,
+    long	len,
+    linenr_T	line_count)
+{
+    DATA_BL	*dp = (DATA_BL *)data;
+    char_u	*p = text;
+    char_u	*end;
+    char_u	*s;
+    long	n;
+
+    vim_memset(data, 0, (size_t)size);
+    dp->db_id = DATA_ID;
+    dp->db_txt_start = dp->db_txt_end = size;
+    dp->db_free = dp->db_txt_start - HEADER_SIZE;
+    dp->db_line_count = 0;
+
+    while (p < text + len)
+    {
+	end = (char_u *)memchr(p, NL, (size_t)(text + len - p));
+	if (end == NULL || dp->db_line_count >= line_count)
+	    return FAIL;
+	n = (long)(end - p) + 1;
+	if ((long)dp->db_free < n + (long)INDEX_SIZE)
+	    return FAIL;
+	dp->db_txt_start -= n;
+	dp->db_free -= n + INDEX_SIZE;
+	dp->db_index[dp->db_line_count++] = dp->db_txt_start;
+	for (s = data + dp->db_txt_start; p < end; ++p, ++s)
+	    *s = *p == NUL ? NL : *p;
+	*s = NUL;
+	++p;
+    }
+    return dp->db_line_count == line_count ? OK : FAIL;
+}
+
+/*
+ * Return the number of lines in data block "data".
+ */
+    linenr_T
+ml_data_line_count(char_u *data)
+{
+    return ((DATA_BL *)data)->db_line_count;
+}
+
+/*
+ * Stop reading unchanged blocks of buffer "buf" from the edited file.  Used
+ * before the file is overwritten.
+ */
+    void
+ml_close_source(buf_T *buf)
+{
+    if (buf->b_ml.ml_mfp == NULL || buf->b_ml.ml_mfp->mf_src_fd < 0)
+	return;
+    ml_flush_line(buf);
+    (void)ml_find_line(buf, (linenr_T)0, ML_FLUSH);
+    mf_close_source(buf->b_ml.ml_mfp);
+    buf->b_ml.ml_stack_top = 0;
+}
+
 /*
  * create a new, empty, pointer block
  */
@@ -5487,12 +5778,275 @@ ml_crypt_prepare(memfile_T *mfp, off_T offset, int reading)
 #define MLCS_MAXL 800	// max no of lines in chunk
 #define MLCS_MINL 400   // should be half of MLCS_MAXL
 
+/*
+ * The chunks are also a Fenwick tree: the mlcs_tree_ fields of chunk "i"
+ * hold the sums for chunks (i & (i + 1)) to "i".  This way finding the chunk
+ * for a line or byte offset and updating the sums takes O(log n) time.
+ * Only when chunks are split or joined the tree is built again.
+ */
+
+/*
+ * Add "lines" and "size" to chunk "idx" in the tree.
+ */
+    static void
+ml_chunk_tree_add(buf_T *buf, int idx, int lines, long size)
+{
+    chunksize_T	*chunks = buf->b_ml.ml_chunksize;
+
+    for ( ; idx < buf->b_ml.ml_usedchunks; idx |= idx + 1)
+    {
+	chunks[idx].mlcs_tree_numlines += lines;
+	chunks[idx].mlcs_tree_totalsize += size;
+    }
+}
+
+/*
+ * Compute the tree sums of chunk "idx", using the chunks before it.
+ */
+    static void
+ml_chunk_tree_set(buf_T *buf, int idx)
+{
+    chunksize_T	*chunks = buf->b_ml.ml_chunksize;
+    int		i;
+
+    chunks[idx].mlcs_tree_numlines = chunks[idx].mlcs_numlines;
+    chunks[idx].mlcs_tree_totalsize = chunks[idx].mlcs_totalsize;
+    for (i = idx - 1; i >= (idx & (idx + 1)); i = (i & (i + 1)) - 1)
+    {
+	chunks[idx].mlcs_tree_numlines += chunks[i].mlcs_tree_numlines;
+	chunks[idx].mlcs_tree_totalsize += chunks[i].mlcs_tree_totalsize;
+    }
+}
+
+/*
+ * Build the tree for all chunks, after chunks were inserted or removed.
+ */
+    static void
+ml_chunk_tree_build(buf_T *buf)
+{
+    chunksize_T	*chunks = buf->b_ml.ml_chunksize;
+    int		used = buf->b_ml.ml_usedchunks;
+    int		i;
+    int		p;
+
+    for (i = 0; i < used; ++i)
+    {
+	chunks[i].mlcs_tree_numlines = chunks[i].mlcs_numlines;
+	chunks[i].mlcs_tree_totalsize = chunks[i].mlcs_totalsize;
+    }
+    for (i = 0; i < used; ++i)
+    {
+	p = i | (i + 1);
+	if (p < used)
+	{
+	    chunks[p].mlcs_tree_numlines += chunks[i].mlcs_tree_numlines;
+	    chunks[p].mlcs_tree_totalsize += chunks[i].mlcs_tree_totalsize;
+	}
+    }
+}
+
+/*
+ * Return the number of chunks before the one containing line "lnum", or byte
+ * "offset" when "lnum" is zero.  With "ffdos" a CR is counted for each line.
+ */
+    static int
+ml_chunk_count(buf_T *buf, linenr_T lnum, long offset, int ffdos)
+{
+    chunksize_T	*chunks = buf->b_ml.ml_chunksize;
+    int		used = buf->b_ml.ml_usedchunks;
+    int		step;
+    int		count = 0;
+    linenr_T	lines = 0;
+    long	size = 0;
+    chunksize_T	*cp;
+
+    for (step = 1; step * 2 <= used; step *= 2)
+	;
+    for ( ; step > 0; step /= 2)
+    {
+	if (count + step > used)
+	    continue;
+	cp = chunks + count + step - 1;
+	if (lnum != 0 ? lnum >= 1 + lines + cp->mlcs_tree_numlines
+		: offset > size + cp->mlcs_tree_totalsize
+			     + (long)ffdos * (lines + cp->mlcs_tree_numlines))
+	{
+	    count += step;
+	    lines += cp->mlcs_tree_numlines;
+	    size += cp->mlcs_tree_totalsize;
+	}
+    }
+    return count;
+}
+
+/*
+ * Find the chunk with line "lnum" if it is not zero, and the chunk with byte
+ * "offset" if it is not zero.  When both are given the later chunk is used.
+ * The last chunk is used when beyond the end.
+ * "*linep" is set to the first line in the chunk and, when "sizep" is not
+ * NULL, "*sizep" to the number of bytes before it.  With "ffdos" a CR is
+ * counted for each line when "offset" is not zero.
+ * Returns the index of the chunk.
+ */
+    static int
+ml_chunk_find(
+    buf_T	*buf,
+    linenr_T	lnum,
+    long	offset,
+    int		ffdos,
+    linenr_T	*linep,
+    long	*sizep)
+{
+    chunksize_T	*chunks = buf->b_ml.ml_chunksize;
+    int		idx = 0;
+    int		i;
+    linenr_T	lines = 0;
+    long	size = 0;
+
+    if (lnum != 0)
+	idx = ml_chunk_count(buf, lnum, 0L, FALSE);
+    if (offset != 0)
+    {
+	i = ml_chunk_count(buf, 0, offset, ffdos);
+	if (i > idx)
+	    idx = i;
+    }
+    if (idx > buf->b_ml.ml_usedchunks - 1)
+	idx = buf->b_ml.ml_usedchunks - 1;
+
+    for (i = idx - 1; i >= 0; i = (i & (i + 1)) - 1)
+    {
+	lines += chunks[i].mlcs_tree_numlines;
+	size += chunks[i].mlcs_tree_totalsize;
+    }
+    *linep = lines + 1;
+    if (sizep != NULL)
+	*sizep = size + (offset != 0 && ffdos ? lines : 0);
+    return idx;
+}
+
+// Remember the chunk where the last line was added, to quickly find the
+// chunk for the next line.
+static buf_T	*ml_upd_lastbuf = NULL;
+static linenr_T	ml_upd_lastline;
+static linenr_T	ml_upd_lastcurline;
+static int	ml_upd_lastcurix;
+
+/*
+ * Make sure there is room for one more chunk.
+ * Returns FAIL when out of memory, the information is then not available.
+ */
+    static int
+ml_chunk_grow(buf_T *buf)
+{
+    chunksize_T *t_chunksize = buf->b_ml.ml_chunksize;
+
+    if (buf->b_ml.ml_usedchunks + 1 < buf->b_ml.ml_numchunks)
+	return OK;
+    buf->b_ml.ml_numchunks = buf->b_ml.ml_numchunks * 3 / 2;
+    buf->b_ml.ml_chunksize = vim_realloc(buf->b_ml.ml_chunksize,
+			    sizeof(chunksize_T) * buf->b_ml.ml_numchunks);
+    if (buf->b_ml.ml_chunksize == NULL)
+    {
+	// Hmmmm, Give up on offset for this buffer
+	vim_free(t_chunksize);
+	buf->b_ml.ml_usedchunks = -1;
+	return FAIL;
+    }
+    return OK;
+}
+
+/*
+ * Split chunk "curix", which starts at line "curline", in two.  The first one
+ * gets MLCS_MINL lines.  There must be room for one more chunk.
+ * Returns FAIL when the information is not available.
+ */
+    static int
+ml_chunk_split(buf_T *buf, int curix, linenr_T curline)
+{
+    int		count;		// number of entries in block
+    int		idx;
+    int		end_idx;
+    int		text_end;
+    int		linecnt;
+    long	size;
+    int		rest;
+    bhdr_T	*hp;
+    DATA_BL	*dp;
+
+    mch_memmove(buf->b_ml.ml_chunksize + curix + 1,
+		buf->b_ml.ml_chunksize + curix,
+		(buf->b_ml.ml_usedchunks - curix) *
+		sizeof(chunksize_T));
+    // Compute length of first half of lines in the split chunk
+    size = 0;
+    linecnt = 0;
+    while (curline < buf->b_ml.ml_line_count
+		&& linecnt < MLCS_MINL)
+    {
+	if ((hp = ml_find_line(buf, curline, ML_FIND)) == NULL)
+	{
+	    buf->b_ml.ml_usedchunks = -1;
+	    return FAIL;
+	}
+	dp = (DATA_BL *)(hp->bh_data);
+	count = (long)(buf->b_ml.ml_locked_high) -
+		(long)(buf->b_ml.ml_locked_low) + 1;
+	idx = curline - buf->b_ml.ml_locked_low;
+	curline = buf->b_ml.ml_locked_high + 1;
+
+	// compute index of last line to use in this MEMLINE
+	rest = count - idx;
+	if (linecnt + rest > MLCS_MINL)
+	{
+	    end_idx = idx + MLCS_MINL - linecnt - 1;
+	    linecnt = MLCS_MINL;
+	}
+	else
+	{
+	    end_idx = count - 1;
+	    linecnt += rest;
+	}
+#ifdef FEAT_PROP_POPUP
+	if (buf->b_has_textprop)
+	{
+	    int i;
+
+	    // We cannot use the text pointers to get the text length,
+	    // the text prop info would also be counted.  Go over the
+	    // lines.
+	    for (i = end_idx; i < idx; ++i)
+		size += (int)STRLEN((char_u *)dp + (dp->db_index[i] & DB_INDEX_MASK)) + 1;
+	}
+	else
+#endif
+	{
+	    if (idx == 0) // first line in block, text at the end
+		text_end = dp->db_txt_end;
+	    else
+		text_end = ((dp->db_index[idx - 1]) & DB_INDEX_MASK);
+	    size += text_end - ((dp->db_index[end_idx]) & DB_INDEX_MASK);
+	}
+    }
+    buf->b_ml.ml_chunksize[curix].mlcs_numlines = linecnt;
+    buf->b_ml.ml_chunksize[curix + 1].mlcs_numlines -= linecnt;
+    buf->b_ml.ml_chunksize[curix].mlcs_totalsize = size;
+    buf->b_ml.ml_chunksize[curix + 1].mlcs_totalsize -= size;
+    buf->b_ml.ml_usedchunks++;
+    ml_chunk_tree_build(buf);
+    ml_upd_lastbuf = NULL;   // Force recalc of curix & curline
+    return OK;
+}
+
 /*
  * Keep information for finding byte offset of a line, updtype may be one of:
  * ML_CHNK_ADDLINE: Add len to parent chunk, possibly splitting it
  *	   Careful: ML_CHNK_ADDLINE may cause ml_find_line() to be called.
  * ML_CHNK_DELLINE: Subtract len from parent chunk, possibly deleting it
  * ML_CHNK_UPDLINE: Add len to parent chunk, as a signed entity.
+ * ML_CHNK_ADDLINE_NOSPLIT: Like ML_CHNK_ADDLINE, but don't split the chunk,
+ *	   for when more lines were added.  Use ml_chunk_split_lines() when
+ *	   done.
  */
     static void
 ml_updatechunk(
@@ -5501,21 +6055,21 @@ ml_updatechunk(
     long	len,
     int		updtype)
 {
-    static buf_T	*ml_upd_lastbuf = NULL;
-    static linenr_T	ml_upd_lastline;
-    static linenr_T	ml_upd_lastcurline;
-    static int		ml_upd_lastcurix;
-
     linenr_T		curline = ml_upd_lastcurline;
     int			curix = ml_upd_lastcurix;
-    long		size;
     chunksize_T		*curchnk;
     int			rest;
     bhdr_T		*hp;
     DATA_BL		*dp;
+    int			split = TRUE;
 
     if (buf->b_ml.ml_usedchunks == -1 || len == 0)
 	return;
+    if (updtype == ML_CHNK_ADDLINE_NOSPLIT)
+    {
+	updtype = ML_CHNK_ADDLINE;
+	split = FALSE;
+    }
     if (buf->b_ml.ml_chunksize == NULL)
     {
 	buf->b_ml.ml_chunksize = ALLOC_MULT(chunksize_T, 100);
@@ -5528,6 +6082,7 @@ ml_updatechunk(
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = 1;
+	ml_chunk_tree_build(buf);
     }
 
     if (updtype == ML_CHNK_UPDLINE && buf->b_ml.ml_line_count == 1)
@@ -5538,6 +6093,7 @@ ml_updatechunk(
 	buf->b_ml.ml_usedchunks = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_numlines = 1;
 	buf->b_ml.ml_chunksize[0].mlcs_totalsize = (long)buf->b_ml.ml_line_len;
+	ml_chunk_tree_build(buf);
 	return;
     }
 
@@ -5547,13 +6103,7 @@ ml_updatechunk(
      */
     if (buf != ml_upd_lastbuf || line != ml_upd_lastline + 1
 	    || updtype != ML_CHNK_ADDLINE)
-    {
-	for (curline = 1, curix = 0;
-	     curix < buf->b_ml.ml_usedchunks - 1
-	     && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	     curix++)
-	    curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-    }
+	curix = ml_chunk_find(buf, line, 0L, FALSE, &curline, NULL);
     else if (curix < buf->b_ml.ml_usedchunks - 1
 	      && line >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
     {
@@ -5566,98 +6116,23 @@ ml_updatechunk(
     if (updtype == ML_CHNK_DELLINE)
 	len = -len;
     curchnk->mlcs_totalsize += len;
+    ml_chunk_tree_add(buf, curix, updtype == ML_CHNK_ADDLINE ? 1
+				 : updtype == ML_CHNK_DELLINE ? -1 : 0, len);
     if (updtype == ML_CHNK_ADDLINE)
     {
 	curchnk->mlcs_numlines++;
 
 	// May resize here so we don't have to do it in both cases below
-	if (buf->b_ml.ml_usedchunks + 1 >= buf->b_ml.ml_numchunks)
-	{
-	    chunksize_T *t_chunksize = buf->b_ml.ml_chunksize;
-
-	    buf->b_ml.ml_numchunks = buf->b_ml.ml_numchunks * 3 / 2;
-	    buf->b_ml.ml_chunksize = vim_realloc(buf->b_ml.ml_chunksize,
-			    sizeof(chunksize_T) * buf->b_ml.ml_numchunks);
-	    if (buf->b_ml.ml_chunksize == NULL)
-	    {
-		// Hmmmm, Give up on offset for this buffer
-		vim_free(t_chunksize);
-		buf->b_ml.ml_usedchunks = -1;
-		return;
-	    }
-	}
+	if (ml_chunk_grow(buf) == FAIL)
+	    return;
 
-	if (buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MAXL)
+	if (split && buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MAXL)
 	{
-	    int	    count;	    // number of entries in block
-	    int	    idx;
-	    int	    end_idx;
-	    int	    text_end;
-	    int	    linecnt;
-
-	    mch_memmove(buf->b_ml.ml_chunksize + curix + 1,
-			buf->b_ml.ml_chunksize + curix,
-			(buf->b_ml.ml_usedchunks - curix) *
-			sizeof(chunksize_T));
-	    // Compute length of first half of lines in the split chunk
-	    size = 0;
-	    linecnt = 0;
-	    while (curline < buf->b_ml.ml_line_count
-			&& linecnt < MLCS_MINL)
-	    {
-		if ((hp = ml_find_line(buf, curline, ML_FIND)) == NULL)
-		{
-		    buf->b_ml.ml_usedchunks = -1;
-		    return;
-		}
-		dp = (DATA_BL *)(hp->bh_data);
-		count = (long)(buf->b_ml.ml_locked_high) -
-			(long)(buf->b_ml.ml_locked_low) + 1;
-		idx = curline - buf->b_ml.ml_locked_low;
-		curline = buf->b_ml.ml_locked_high + 1;
-
-		// compute index of last line to use in this MEMLINE
-		rest = count - idx;
-		if (linecnt + rest > MLCS_MINL)
-		{
-		    end_idx = idx + MLCS_MINL - linecnt - 1;
-		    linecnt = MLCS_MINL;
-		}
-		else
-		{
-		    end_idx = count - 1;
-		    linecnt += rest;
-		}
-#ifdef FEAT_PROP_POPUP
-		if (buf->b_has_textprop)
-		{
-		    int i;
-
-		    // We cannot use the text pointers to get the text length,
-		    // the text prop info would also be counted.  Go over the
-		    // lines.
-		    for (i = end_idx; i < idx; ++i)
-			size += (int)STRLEN((char_u *)dp + (dp->db_index[i] & DB_INDEX_MASK)) + 1;
-		}
-		else
-#endif
-		{
-		    if (idx == 0) // first line in block, text at the end
-			text_end = dp->db_txt_end;
-		    else
-			text_end = ((dp->db_index[idx - 1]) & DB_INDEX_MASK);
-		    size += text_end - ((dp->db_index[end_idx]) & DB_INDEX_MASK);
-		}
-	    }
-	    buf->b_ml.ml_chunksize[curix].mlcs_numlines = linecnt;
-	    buf->b_ml.ml_chunksize[curix + 1].mlcs_numlines -= linecnt;
-	    buf->b_ml.ml_chunksize[curix].mlcs_totalsize = size;
-	    buf->b_ml.ml_chunksize[curix + 1].mlcs_totalsize -= size;
-	    buf->b_ml.ml_usedchunks++;
-	    ml_upd_lastbuf = NULL;   // Force recalc of curix & curline
+	    (void)ml_chunk_split(buf, curix, curline);
 	    return;
 	}
-	else if (buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MINL
+	else if (split
+		&& buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MINL
 		     && curix == buf->b_ml.ml_usedchunks - 1
 		     && buf->b_ml.ml_line_count - line <= 1)
 	{
@@ -5695,7 +6170,9 @@ ml_updatechunk(
 		curchnk->mlcs_numlines = 1;
 		curchnk[-1].mlcs_totalsize -= rest;
 		curchnk[-1].mlcs_numlines -= 1;
+		ml_chunk_tree_add(buf, curix, -1, -rest);
 	    }
+	    ml_chunk_tree_set(buf, curix + 1);
 	}
     }
     else if (updtype == ML_CHNK_DELLINE)
@@ -5714,6 +6191,7 @@ ml_updatechunk(
 	    buf->b_ml.ml_usedchunks--;
 	    mch_memmove(buf->b_ml.ml_chunksize, buf->b_ml.ml_chunksize + 1,
 			buf->b_ml.ml_usedchunks * sizeof(chunksize_T));
+	    ml_chunk_tree_build(buf);
 	    return;
 	}
 	else if (curix == 0 || (curchnk->mlcs_numlines > 10
@@ -5734,6 +6212,7 @@ ml_updatechunk(
 			(buf->b_ml.ml_usedchunks - curix) *
 			sizeof(chunksize_T));
 	}
+	ml_chunk_tree_build(buf);
 	return;
     }
     ml_upd_lastbuf = buf;
@@ -5742,6 +6221,30 @@ ml_updatechunk(
     ml_upd_lastcurix = curix;
 }
 
+/*
+ * Split the chunks for lines "first" to "last" that have too many lines,
+ * after adding lines with ML_CHNK_ADDLINE_NOSPLIT.
+ */
+    static void
+ml_chunk_split_lines(buf_T *buf, linenr_T first, linenr_T last)
+{
+    linenr_T	curline;
+    int		curix;
+
+    if (buf->b_ml.ml_usedchunks == -1 || buf->b_ml.ml_chunksize == NULL)
+	return;
+    curix = ml_chunk_find(buf, first, 0L, FALSE, &curline, NULL);
+    while (curix < buf->b_ml.ml_usedchunks && curline <= last)
+    {
+	if (buf->b_ml.ml_chunksize[curix].mlcs_numlines >= MLCS_MAXL
+		&& (ml_chunk_grow(buf) == FAIL
+			       || ml_chunk_split(buf, curix, curline) == FAIL))
+	    return;
+	curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
+	++curix;
+    }
+}
+
 /*
  * Find offset for line or line with offset.
  * Find line with offset if "lnum" is 0; return remaining offset in offp
@@ -5752,7 +6255,6 @@ ml_updatechunk(
 ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp)
 {
     linenr_T	curline;
-    int		curix;
     long	size;
     bhdr_T	*hp;
     DATA_BL	*dp;
@@ -5780,24 +6282,9 @@ ml_find_line_or_offset(buf_T *buf, linenr_T lnum, long *offp)
     if (lnum == 0 && offset <= 0)
 	return 1;   // Not a "find offset" and offset 0 _must_ be in line 1
     /*
-     * Find the last chunk before the one containing our line. Last chunk is
-     * special because it will never qualify.
+     * Find the chunk containing our line.
      */
-    curline = 1;
-    curix = size = 0;
-    while (curix < buf->b_ml.ml_usedchunks - 1
-	    && ((lnum != 0
-	     && lnum >= curline + buf->b_ml.ml_chunksize[curix].mlcs_numlines)
-		|| (offset != 0
-	       && offset > size + buf->b_ml.ml_chunksize[curix].mlcs_totalsize
-		 + (long)ffdos * buf->b_ml.ml_chunksize[curix].mlcs_numlines)))
-    {
-	curline += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	size += buf->b_ml.ml_chunksize[curix].mlcs_totalsize;
-	if (offset && ffdos)
-	    size += buf->b_ml.ml_chunksize[curix].mlcs_numlines;
-	curix++;
-    }
+    (void)ml_chunk_find(buf, lnum, offset, ffdos, &curline, &size);
 
     while ((lnum != 0 && curline < lnum) || (offset != 0 && size < offset))
     {
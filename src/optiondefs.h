@@ -2937,6 +2937,7 @@ static struct vimoption options[] =
     p_term("t_bc", T_BC)
     p_term("t_BE", T_BE)
     p_term("t_BD", T_BD)
+    p_term("t_BS", T_BS)
     p_term("t_cd", T_CD)
     p_term("t_ce", T_CE)
     p_term("t_cl", T_CL)
@@ -2953,6 +2954,7 @@ static struct vimoption options[] =
     p_term("t_dl", T_DL)
     p_term("t_EC", T_CEC)
     p_term("t_EI", T_CEI)
+    p_term("t_ES", T_ES)
     p_term("t_fs", T_FS)
     p_term("t_fd", T_FD)
     p_term("t_fe", T_FE)
@@ -2973,6 +2975,7 @@ static struct vimoption options[] =
     p_term("t_RB", T_RBG)
     p_term("t_RC", T_CRC)
     p_term("t_RI", T_CRI)
+    p_term("t_RP", T_RP)
     p_term("t_Ri", T_SRI)
     p_term("t_RS", T_CRS)
     p_term("t_RT", T_CRT)
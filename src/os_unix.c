@@ -364,11 +364,39 @@ mch_chdir(char *path)
 
 /*
  * Write s[len] to the screen (stdout).
+ * A screen update can be large, write() may then write only part of it when
+ * interrupted by a signal or when stdout is non-blocking.  Keep writing until
+ * all of it was written or an error other than that happens.
  */
     void
 mch_write(char_u *s, int len)
 {
-    vim_ignored = (int)write(1, (char *)s, len);
+    int	    n;
+
+    while (len > 0)
+    {
+	n = (int)write(1, (char *)s, len);
+	if (n > 0)
+	{
+	    s += n;
+	    len -= n;
+	}
+# ifdef EAGAIN
+	else if (n < 0 && (errno == EAGAIN
+#  if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+		    || errno == EWOULDBLOCK
+#  endif
+		    ))
+	    // terminal can't keep up, wait a moment
+	    mch_delay(1L, MCH_DELAY_IGNOREINPUT);
+# endif
+# ifdef EINTR
+	else if (n < 0 && errno == EINTR)
+	    continue;
+# endif
+	else
+	    break;
+    }
     if (p_wd)		// Unix is too fast, slow down a bit more
 	RealWaitForChar(read_cmd_fd, p_wd, NULL, NULL);
 }
@@ -12,6 +12,10 @@ int mf_sync(memfile_T *mfp, int flags);
 void mf_set_dirty(memfile_T *mfp);
 int mf_release_all(void);
 blocknr_T mf_trans_del(memfile_T *mfp, blocknr_T old_nr);
+int mf_set_source(memfile_T *mfp, int fd);
+void mf_src_append(memfile_T *mfp, bhdr_T *hp, int idx, off_T offset, long len);
+void mf_src_forget(memfile_T *mfp, bhdr_T *hp);
+void mf_close_source(memfile_T *mfp);
 void mf_set_ffname(memfile_T *mfp);
 void mf_fullname(memfile_T *mfp);
 int mf_need_trans(memfile_T *mfp);
@@ -23,6 +23,7 @@ char_u *ml_get_buf(buf_T *buf, linenr_T lnum, int will_change);
 int ml_line_alloced(void);
 int ml_append(linenr_T lnum, char_u *line, colnr_T len, int newfile);
 int ml_append_flags(linenr_T lnum, char_u *line, colnr_T len, int flags);
+int ml_append_bulk(linenr_T lnum, char_u **lines, long count, int flags);
 int ml_append_buf(buf_T *buf, linenr_T lnum, char_u *line, colnr_T len, int newfile);
 int ml_replace(linenr_T lnum, char_u *line, int copy);
 int ml_replace_len(linenr_T lnum, char_u *line_arg, colnr_T len_arg, int has_props, int copy);
@@ -31,6 +32,9 @@ int ml_delete_flags(linenr_T lnum, int flags);
 void ml_setmarked(linenr_T lnum);
 linenr_T ml_firstmarked(void);
 void ml_clearmarked(void);
+int ml_fill_data_block(char_u *data, unsigned size, char_u *text, long len, linenr_T line_count);
+linenr_T ml_data_line_count(char_u *data);
+void ml_close_source(buf_T *buf);
 int resolve_symlink(char_u *fname, char_u *buf);
 char_u *makeswapname(char_u *fname, char_u *ffname, buf_T *buf, char_u *dir_name);
 char_u *get_file_in_dir(char_u *fname, char_u *dname);
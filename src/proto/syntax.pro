@@ -1,6 +1,9 @@
 /* syntax.c */
 void syn_set_timeout(proftime_T *tm);
 void syntax_start(win_T *wp, linenr_T lnum);
+int syntax_has_saved_state(win_T *wp, linenr_T lnum);
+int syntax_bg_pending(win_T *wp);
+void syntax_bg_parse(win_T *wp, long msec);
 void syn_stack_free_all(synblock_T *block);
 void syn_stack_apply_changes(buf_T *buf);
 void syntax_end_parsing(linenr_T lnum);
@@ -13,6 +13,8 @@ int term_is_gui(char_u *name);
 char_u *tltoa(unsigned long i);
 void termcapinit(char_u *name);
 void out_flush(void);
+void out_frame_start(void);
+void out_frame_end(void);
 void out_flush_cursor(int force, int clear_selection);
 void out_flush_check(void);
 void out_trash(void);
@@ -22,6 +24,7 @@ void out_str_cf(char_u *s);
 void out_str(char_u *s);
 void term_windgoto(int row, int col);
 void term_cursor_right(int i);
+void term_repeat_char(int n);
 void term_append_lines(int line_count);
 void term_delete_lines(int line_count);
 void term_set_winpos(int x, int y);
@@ -68,6 +68,7 @@ int generate_store_var(cctx_T *cctx, assign_dest_T dest, int opt_flags, int vimv
 int inside_loop_scope(cctx_T *cctx);
 int generate_store_lhs(cctx_T *cctx, lhs_T *lhs, int instr_count, int is_decl);
 void may_generate_prof_end(cctx_T *cctx, int prof_lnum);
+void optimize_instructions(garray_T *instr);
 void delete_instr(isn_T *isn);
 void clear_instr_ga(garray_T *gap);
 /* vim: set ft=c : */
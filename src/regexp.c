@@ -99,6 +99,10 @@ re_multi_type(int c)
 
 static char_u		*reg_prev_sub = NULL;
 
+// Set when the pattern being compiled uses "reg_prev_sub" (the "~" atom).
+// Such a program can't be cached, the previous substitute string may change.
+static int		reg_used_prev_sub = FALSE;
+
 /*
  * REGEXP_INRANGE contains all characters which are always special in a []
  * range after '\'.
@@ -1615,6 +1619,18 @@ cstrchr(char_u *s, int c)
     else
 	return vim_strchr(s, c);
 
+    // When both are bytes that can't be part of a multibyte character let
+    // the library function find them, it is usually much faster.
+    if (!has_mbyte || (enc_utf8 && c < 0x80 && cc < 0x80))
+    {
+	char	both[3];
+
+	both[0] = c;
+	both[1] = cc;
+	both[2] = NUL;
+	return (char_u *)strpbrk((char *)s, both);
+    }
+
     if (has_mbyte)
     {
 	for (p = s; *p != NUL; p += (*mb_ptr2len)(p))
@@ -1637,6 +1653,47 @@ cstrchr(char_u *s, int c)
     return NULL;
 }
 
+/*
+ * Find the string "must", which is "mlen" bytes long and NUL terminated, in
+ * "s".  Used to quickly skip lines that can't match, thus a match that isn't
+ * on a character boundary is acceptable.
+ * Returns NULL if it's not there.
+ */
+    static char_u *
+reg_find_must(char_u *s, char_u *must, int mlen)
+{
+    int		c;
+    int		len;
+
+    // In UTF-8 the library function can be used for an exact match, it is
+    // usually much faster than comparing at every occurrence of the first
+    // character.
+    if (!rex.reg_ic && !rex.reg_icombine && (!has_mbyte || enc_utf8))
+	return (char_u *)strstr((char *)s, (char *)must);
+
+    if (has_mbyte)
+	c = (*mb_ptr2char)(must);
+    else
+	c = *must;
+    if (!rex.reg_ic || (!enc_utf8 && mb_char2len(c) > 1))
+	while ((s = vim_strchr(s, c)) != NULL)
+	{
+	    len = mlen;
+	    if (cstrncmp(s, must, &len) == 0)
+		break;		// Found it.
+	    MB_PTR_ADV(s);
+	}
+    else
+	while ((s = cstrchr(s, c)) != NULL)
+	{
+	    len = mlen;
+	    if (cstrncmp(s, must, &len) == 0)
+		break;		// Found it.
+	    MB_PTR_ADV(s);
+	}
+    return s;
+}
+
 ////////////////////////////////////////////////////////////////
 //		      regsub stuff			      //
 ////////////////////////////////////////////////////////////////
@@ -2561,6 +2618,188 @@ static char_u regname[][30] = {
 			    };
 #endif
 
+/*
+ * Cache of compiled patterns that are not used at the moment.  When the same
+ * pattern is compiled again, e.g. by matchstr() in a loop, the program is
+ * taken from the cache instead of compiling it.  vim_regfree() puts a
+ * program in the cache, vim_regcomp() takes it out again.  A program is only
+ * given to one user at a time, it contains the state of a match in progress.
+ */
+#define REGCACHE_MAX	32	// maximum number of programs in the cache
+
+typedef struct regcache_S regcache_T;
+struct regcache_S
+{
+    regcache_T	*rc_next;	// next in the cache, more recently used
+    regcache_T	*rc_prev;	// previous in the cache, less recently used
+    regprog_T	*rc_prog;	// the program when in the cache, else NULL
+    hash_T	rc_hash;	// hash of rc_pat
+    int		rc_flags;	// "re_flags" argument of vim_regcomp()
+    int		rc_engine;	// 'regexpengine' used for compiling
+    int		rc_opts;	// REGCACHE_ flags used for compiling
+    int		rc_dbcs;	// value of "enc_dbcs" used for compiling
+#ifdef FEAT_SYN_HL
+    int		rc_had_eol;	// value of "had_eol" after compiling
+#endif
+    char_u	rc_pat[1];	// the pattern, actually longer
+};
+
+// Options that change how a pattern is compiled.
+#define REGCACHE_UTF8	    1	// 'encoding' is UTF-8
+#define REGCACHE_MBYTE	    2	// 'encoding' is multibyte
+#define REGCACHE_CPO_LIT    4	// 'cpoptions' contains 'l'
+#define REGCACHE_CPO_BSL    8	// 'cpoptions' contains '\'
+
+static regcache_T   *regcache_first = NULL;	// least recently used
+static regcache_T   *regcache_last = NULL;	// most recently used
+static int	    regcache_count = 0;
+
+/*
+ * Return the REGCACHE_ flags for the current option values.
+ */
+    static int
+regcache_opts(void)
+{
+    return (enc_utf8 ? REGCACHE_UTF8 : 0)
+	| (has_mbyte ? REGCACHE_MBYTE : 0)
+	| (vim_strchr(p_cpo, CPO_LITERAL) != NULL ? REGCACHE_CPO_LIT : 0)
+	| (vim_strchr(p_cpo, CPO_BACKSL) != NULL ? REGCACHE_CPO_BSL : 0);
+}
+
+/*
+ * Remove "rc" from the cache.
+ */
+    static void
+regcache_unlink(regcache_T *rc)
+{
+    if (rc->rc_prev == NULL)
+	regcache_first = rc->rc_next;
+    else
+	rc->rc_prev->rc_next = rc->rc_next;
+    if (rc->rc_next == NULL)
+	regcache_last = rc->rc_prev;
+    else
+	rc->rc_next->rc_prev = rc->rc_prev;
+    rc->rc_next = NULL;
+    rc->rc_prev = NULL;
+    rc->rc_prog = NULL;
+    --regcache_count;
+}
+
+/*
+ * Free the program in the cache entry "rc" and the entry itself.
+ */
+    static void
+regcache_free(regcache_T *rc)
+{
+    regprog_T	*prog = rc->rc_prog;
+
+    regcache_unlink(rc);
+    prog->engine->regfree(prog);
+    vim_free(rc);
+}
+
+/*
+ * Find a program for pattern "expr" compiled with "re_flags" in the cache.
+ * Returns NULL when there is none.
+ */
+    static regprog_T *
+regcache_find(char_u *expr, int re_flags)
+{
+    hash_T	hash = hash_hash(expr);
+    int		opts = regcache_opts();
+    regcache_T	*rc;
+    regprog_T	*prog;
+
+    for (rc = regcache_last; rc != NULL; rc = rc->rc_prev)
+	if (rc->rc_hash == hash && rc->rc_flags == re_flags
+		&& rc->rc_engine == p_re && rc->rc_opts == opts
+		&& rc->rc_dbcs == enc_dbcs
+		&& STRCMP(rc->rc_pat, expr) == 0)
+	{
+	    prog = rc->rc_prog;
+	    regcache_unlink(rc);
+#ifdef FEAT_SYN_HL
+	    had_eol = rc->rc_had_eol;
+#endif
+	    return prog;
+	}
+    return NULL;
+}
+
+/*
+ * Remember that "prog" was compiled from "expr" with "re_flags", so that
+ * vim_regfree() can put it in the cache.
+ */
+    static void
+regcache_remember(regprog_T *prog, char_u *expr, int re_flags)
+{
+    regcache_T	*rc;
+
+    rc = alloc(offsetof(regcache_T, rc_pat) + STRLEN(expr) + 1);
+    if (rc == NULL)
+	return;
+    rc->rc_next = NULL;
+    rc->rc_prev = NULL;
+    rc->rc_prog = NULL;
+    rc->rc_hash = hash_hash(expr);
+    rc->rc_flags = re_flags;
+    rc->rc_engine = p_re;
+    rc->rc_opts = regcache_opts();
+    rc->rc_dbcs = enc_dbcs;
+#ifdef FEAT_SYN_HL
+    rc->rc_had_eol = had_eol;
+#endif
+    STRCPY(rc->rc_pat, expr);
+    prog->re_cache = rc;
+}
+
+/*
+ * Put "prog" in the cache.  When the cache is full the least recently used
+ * program is freed.
+ */
+    static void
+regcache_add(regprog_T *prog)
+{
+    regcache_T	*rc = prog->re_cache;
+
+    if (regcache_count >= REGCACHE_MAX)
+	regcache_free(regcache_first);
+
+    rc->rc_prog = prog;
+    rc->rc_prev = regcache_last;
+    if (regcache_last == NULL)
+	regcache_first = rc;
+    else
+	regcache_last->rc_next = rc;
+    regcache_last = rc;
+    ++regcache_count;
+}
+
+/*
+ * Make the cache entry "rc", which was used for a program that turned out to
+ * be too expensive for the NFA engine, be used for "prog", which was compiled
+ * with the backtracking engine.  Thus when the same pattern is compiled again
+ * the backtracking program is found in the cache.
+ */
+    static void
+regcache_replace(regprog_T *prog, regcache_T *rc)
+{
+    if (rc == NULL)
+	return;
+    if (prog == NULL || prog->re_cache == NULL)
+    {
+	// The backtracking program can't be cached.
+	vim_free(rc);
+	return;
+    }
+#ifdef FEAT_SYN_HL
+    rc->rc_had_eol = prog->re_cache->rc_had_eol;
+#endif
+    vim_free(prog->re_cache);
+    prog->re_cache = rc;
+}
+
 /*
  * Compile a regular expression into internal code.
  * Returns the program in allocated memory.
@@ -2573,6 +2812,17 @@ vim_regcomp(char_u *expr_arg, int re_flags)
     regprog_T   *prog = NULL;
     char_u	*expr = expr_arg;
     int		called_emsg_before;
+    int		called_emsg_start = called_emsg;
+
+#ifdef FEAT_SYN_HL
+    // A pattern for syntax highlighting may be compiled differently.
+    if (reg_do_extmatch == 0)
+#endif
+    {
+	prog = regcache_find(expr_arg, re_flags);
+	if (prog != NULL)
+	    return prog;
+    }
 
     regexp_engine = p_re;
 
@@ -2604,6 +2854,7 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 #endif
     // reg_iswordc() uses rex.reg_buf
     rex.reg_buf = curbuf;
+    reg_used_prev_sub = FALSE;
 
     /*
      * First try the NFA engine, unless backtracking was requested.
@@ -2656,6 +2907,23 @@ vim_regcomp(char_u *expr_arg, int re_flags)
 	// out to be very slow when executing it.
 	prog->re_engine = regexp_engine;
 	prog->re_flags  = re_flags;
+	prog->re_cache = NULL;
+
+	// Can use the program again later, unless an error was given, the
+	// previous substitute string was used or the backtracking engine used
+	// the current 'iskeyword', 'isident', 'isfname' or 'isprint' option
+	// value.
+	if (called_emsg == called_emsg_start
+		&& !reg_used_prev_sub
+#ifdef FEAT_SYN_HL
+		&& reg_do_extmatch == 0
+#endif
+		&& (prog->engine != &bt_regengine
+		    || (strstr((char *)expr, "[:keyword:]") == NULL
+			&& strstr((char *)expr, "[:ident:]") == NULL
+			&& strstr((char *)expr, "[:fname:]") == NULL
+			&& strstr((char *)expr, "[:print:]") == NULL)))
+	    regcache_remember(prog, expr_arg, re_flags);
     }
 
     return prog;
@@ -2667,7 +2935,12 @@ vim_regcomp(char_u *expr_arg, int re_flags)
     void
 vim_regfree(regprog_T *prog)
 {
-    if (prog != NULL)
+    if (prog == NULL)
+	return;
+    if (prog->re_cache != NULL)
+	// Keep it for when the same pattern is compiled again.
+	regcache_add(prog);
+    else
 	prog->engine->regfree(prog);
 }
 
@@ -2675,6 +2948,8 @@ vim_regfree(regprog_T *prog)
     void
 free_regexp_stuff(void)
 {
+    while (regcache_first != NULL)
+	regcache_free(regcache_first);
     ga_clear(&regstack);
     ga_clear(&backpos);
     vim_free(reg_tofree);
@@ -2696,6 +2971,25 @@ report_re_switch(char_u *pat)
 }
 #endif
 
+#if defined(FEAT_SYN_HL) || defined(PROTO)
+/*
+ * Return the character that a match with "prog" must start with, NUL when
+ * it is not known.  When "icp" is not NULL "*icp" is set to TRUE when the
+ * pattern contains "\c".
+ */
+    int
+vim_regprog_startc(regprog_T *prog, int *icp)
+{
+    if (prog == NULL)
+	return NUL;
+    if (icp != NULL)
+	*icp = (prog->regflags & RF_ICASE) != 0;
+    if (prog->engine == &nfa_regengine)
+	return ((nfa_regprog_T *)prog)->regstart;
+    return ((bt_regprog_T *)prog)->regstart;
+}
+#endif
+
 #if defined(FEAT_X11) || defined(PROTO)
 /*
  * Return whether "prog" is currently being executed.
@@ -2752,10 +3046,13 @@ vim_regexec_string(
     if (rmp->regprog->re_engine == AUTOMATIC_ENGINE
 					       && result == NFA_TOO_EXPENSIVE)
     {
-	int    save_p_re = p_re;
-	int    re_flags = rmp->regprog->re_flags;
-	char_u *pat = vim_strsave(((nfa_regprog_T *)rmp->regprog)->pattern);
+	int	    save_p_re = p_re;
+	int	    re_flags = rmp->regprog->re_flags;
+	char_u	    *pat = vim_strsave(((nfa_regprog_T *)rmp->regprog)->pattern);
+	regcache_T  *rc = rmp->regprog->re_cache;
 
+	// Don't cache the NFA program, it would be too expensive again.
+	rmp->regprog->re_cache = NULL;
 	p_re = BACKTRACKING_ENGINE;
 	vim_regfree(rmp->regprog);
 	if (pat != NULL)
@@ -2764,6 +3061,7 @@ vim_regexec_string(
 	    report_re_switch(pat);
 #endif
 	    rmp->regprog = vim_regcomp(pat, re_flags);
+	    regcache_replace(rmp->regprog, rc);
 	    if (rmp->regprog != NULL)
 	    {
 		rmp->regprog->re_in_use = TRUE;
@@ -2869,9 +3167,10 @@ vim_regexec_multi(
     if (rmp->regprog->re_engine == AUTOMATIC_ENGINE
 					       && result == NFA_TOO_EXPENSIVE)
     {
-	int    save_p_re = p_re;
-	int    re_flags = rmp->regprog->re_flags;
-	char_u *pat = vim_strsave(((nfa_regprog_T *)rmp->regprog)->pattern);
+	int	    save_p_re = p_re;
+	int	    re_flags = rmp->regprog->re_flags;
+	char_u	    *pat = vim_strsave(((nfa_regprog_T *)rmp->regprog)->pattern);
+	regcache_T  *rc = rmp->regprog->re_cache;
 
 	p_re = BACKTRACKING_ENGINE;
 	if (pat != NULL)
@@ -2883,8 +3182,11 @@ vim_regexec_multi(
 #endif
 #ifdef FEAT_SYN_HL
 	    // checking for \z misuse was already done when compiling for NFA,
-	    // allow all here
-	    reg_do_extmatch = REX_ALL;
+	    // allow all here.  Not when the NFA program could be cached, it was
+	    // then compiled without \z items and the backtracking program can
+	    // be cached as well.
+	    if (rc == NULL)
+		reg_do_extmatch = REX_ALL;
 #endif
 	    rmp->regprog = vim_regcomp(pat, re_flags);
 #ifdef FEAT_SYN_HL
@@ -2898,7 +3200,10 @@ vim_regexec_multi(
 	    }
 	    else
 	    {
+		// Don't cache the NFA program, it would be too expensive again.
+		prev_prog->re_cache = NULL;
 		vim_regfree(prev_prog);
+		regcache_replace(rmp->regprog, rc);
 
 		rmp->regprog->re_in_use = TRUE;
 		result = rmp->regprog->engine->regexec_multi(
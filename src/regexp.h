@@ -53,6 +53,7 @@ typedef struct regprog
     unsigned		re_engine;   // automatic, backtracking or nfa engine
     unsigned		re_flags;    // second argument for vim_regcomp()
     int			re_in_use;   // prog is being executed
+    struct regcache_S	*re_cache;   // entry for the cache of unused progs
 } regprog_T;
 
 /*
@@ -62,12 +63,13 @@ typedef struct regprog
  */
 typedef struct
 {
-    // These four members implement regprog_T
+    // These six members implement regprog_T
     regengine_T		*engine;
     unsigned		regflags;
     unsigned		re_engine;
     unsigned		re_flags;
     int			re_in_use;
+    struct regcache_S	*re_cache;
 
     int			regstart;
     char_u		reganch;
@@ -99,18 +101,23 @@ struct nfa_state
  */
 typedef struct
 {
-    // These three members implement regprog_T
+    // These six members implement regprog_T
     regengine_T		*engine;
     unsigned		regflags;
     unsigned		re_engine;
     unsigned		re_flags;
     int			re_in_use;
+    struct regcache_S	*re_cache;
 
     nfa_state_T		*start;		// points into state[]
 
     int			reganch;	// pattern starts with ^
     int			regstart;	// char at start of pattern
     char_u		*match_text;	// plain text to match with
+    char_u		*must_text;	// text that must appear or NULL
+    int			must_len;	// length of must_text
+    struct nfa_dfa_S	*dfa;		// lazily built DFA or NULL
+    int			dfa_uses;	// times executed, -1 if no DFA
 
     int			has_zend;	// pattern contains \ze
     int			has_backref;	// pattern contains \1 .. \9
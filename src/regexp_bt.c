@@ -1391,6 +1391,7 @@ regatom(int *flagp)
 	// NOTREACHED
 
       case Magic('~'):		// previous substitute pattern
+	    reg_used_prev_sub = TRUE;
 	    if (reg_prev_sub != NULL)
 	    {
 		char_u	    *lp;
@@ -2553,9 +2554,14 @@ bt_regcomp(char_u *expr, int re_flags)
 
 	// When the r.e. starts with BOW, it is faster to look for a regmust
 	// first. Used a lot for "#" and "*" commands. (Added by mool).
-	if ((flags & SPSTART || OP(scan) == BOW || OP(scan) == EOW)
-							  && !(flags & HASNL))
+	// Also when the longest string is not at the start, e.g. "foo.*bar",
+	// finding it is cheap compared to trying a match at every "f".
+	if (!(flags & HASNL))
 	{
+	    char_u	*first = OP(scan) == EXACTLY ? OPERAND(scan) : NULL;
+	    int		use_must = (flags & SPSTART || OP(scan) == BOW
+							  || OP(scan) == EOW);
+
 	    longest = NULL;
 	    len = 0;
 	    for (; scan != NULL; scan = regnext(scan))
@@ -2564,8 +2570,11 @@ bt_regcomp(char_u *expr, int re_flags)
 		    longest = OPERAND(scan);
 		    len = (int)STRLEN(OPERAND(scan));
 		}
-	    r->regmust = longest;
-	    r->regmlen = len;
+	    if (use_must || (longest != NULL && longest != first))
+	    {
+		r->regmust = longest;
+		r->regmlen = len;
+	    }
 	}
     }
 #ifdef BT_REGEXP_DUMP
@@ -4873,43 +4882,11 @@ bt_regexec_both(
     if (prog->regflags & RF_ICOMBINE)
 	rex.reg_icombine = TRUE;
 
-    // If there is a "must appear" string, look for it.
-    if (prog->regmust != NULL)
-    {
-	int c;
-
-	if (has_mbyte)
-	    c = (*mb_ptr2char)(prog->regmust);
-	else
-	    c = *prog->regmust;
-	s = line + col;
-
-	// This is used very often, esp. for ":global".  Use three versions of
-	// the loop to avoid overhead of conditions.
-	if (!rex.reg_ic && !has_mbyte)
-	    while ((s = vim_strbyte(s, c)) != NULL)
-	    {
-		if (cstrncmp(s, prog->regmust, &prog->regmlen) == 0)
-		    break;		// Found it.
-		++s;
-	    }
-	else if (!rex.reg_ic || (!enc_utf8 && mb_char2len(c) > 1))
-	    while ((s = vim_strchr(s, c)) != NULL)
-	    {
-		if (cstrncmp(s, prog->regmust, &prog->regmlen) == 0)
-		    break;		// Found it.
-		MB_PTR_ADV(s);
-	    }
-	else
-	    while ((s = cstrchr(s, c)) != NULL)
-	    {
-		if (cstrncmp(s, prog->regmust, &prog->regmlen) == 0)
-		    break;		// Found it.
-		MB_PTR_ADV(s);
-	    }
-	if (s == NULL)		// Not present.
-	    goto theend;
-    }
+    // If there is a "must appear" string, look for it.  This is used very
+    // often, esp. for ":global".
+    if (prog->regmust != NULL
+	    && reg_find_must(line + col, prog->regmust, prog->regmlen) == NULL)
+	goto theend;		// Not present.
 
     rex.line = line;
     rex.lnum = 0;
@@ -504,6 +504,146 @@ nfa_get_match_text(nfa_state_T *start)
     return ret;
 }
 
+// Only look for text that must appear in patterns up to this number of
+// states, the check takes time proportional to the square of it.
+#define NFA_MUST_MAX_STATES 500
+
+/*
+ * Return TRUE if NFA_MATCH can be reached from the start of "prog" without
+ * going through state "skip".  "visited" and "stack" have room for all the
+ * states of "prog".
+ */
+    static int
+nfa_match_reachable(
+    nfa_regprog_T	*prog,
+    nfa_state_T		*skip,
+    char_u		*visited,
+    nfa_state_T		**stack)
+{
+    int		sp = 0;
+    nfa_state_T	*state;
+    nfa_state_T	*next[2];
+    int		i;
+
+    vim_memset(visited, 0, prog->nstate);
+    visited[skip - prog->state] = TRUE;
+    visited[prog->start - prog->state] = TRUE;
+    stack[sp++] = prog->start;
+    while (sp > 0)
+    {
+	state = stack[--sp];
+	if (state->c == NFA_MATCH)
+	    return TRUE;
+	next[0] = state->c == NFA_START_COLL || state->c == NFA_START_NEG_COLL
+					     ? state->out1->out : state->out;
+	next[1] = state->c == NFA_SPLIT ? state->out1 : NULL;
+	for (i = 0; i < 2; ++i)
+	    if (next[i] != NULL && !visited[next[i] - prog->state])
+	    {
+		visited[next[i] - prog->state] = TRUE;
+		stack[sp++] = next[i];
+	    }
+    }
+    return FALSE;
+}
+
+/*
+ * Find the longest literal text that every match of "prog" must contain.
+ * Used to quickly skip lines without a match when the pattern is not just
+ * literal text, e.g. "foo.*bar".
+ * Returns the text in allocated memory or NULL.
+ */
+    static char_u *
+nfa_get_must_text(nfa_regprog_T *prog, int *lenp)
+{
+    char_u	*must;
+    char_u	*visited;
+    nfa_state_T	**stack;
+    nfa_state_T	*state;
+    nfa_state_T	*best = NULL;
+    int		best_len = 0;
+    int		best_count = 0;
+    int		len;
+    int		count;
+    int		i;
+    char_u	*ret = NULL;
+    char_u	*s;
+
+    if (prog->nstate > NFA_MUST_MAX_STATES)
+	return NULL;
+    for (i = 0; i < prog->nstate; ++i)
+    {
+	int c = prog->state[i].c;
+
+	// Text after a line break, in a look-around or composing characters
+	// can't be found this way.
+	if (c == NFA_NEWL || (c >= NFA_FIRST_NL && c <= NFA_LAST_NL)
+		|| (c >= NFA_START_INVISIBLE && c <= NFA_OPT_CHARS))
+	    return NULL;
+    }
+
+    must = alloc_clear(prog->nstate);
+    visited = alloc(prog->nstate);
+    stack = ALLOC_MULT(nfa_state_T *, prog->nstate);
+    if (must == NULL || visited == NULL || stack == NULL)
+	goto theend;
+
+    // A character is required when NFA_MATCH can't be reached without it.
+    // Characters inside a collection are never reached.
+    for (i = 0; i < prog->nstate; ++i)
+	if (prog->state[i].c > 0 && !nfa_match_reachable(prog,
+					      &prog->state[i], visited, stack))
+	    must[i] = TRUE;
+
+    // Required characters that directly follow each other must appear
+    // together.
+    for (i = 0; i < prog->nstate; ++i)
+    {
+	if (!must[i])
+	    continue;
+	len = 0;
+	count = 0;
+	for (state = &prog->state[i]; state != NULL && state->c > 0
+			&& must[state - prog->state] && count < prog->nstate;
+							   state = state->out)
+	{
+	    len += MB_CHAR2LEN(state->c);
+	    ++count;
+	}
+	if (len > best_len)
+	{
+	    best = &prog->state[i];
+	    best_len = len;
+	    best_count = count;
+	}
+    }
+
+    // A single character that is also regstart is no use.
+    if (best == NULL || (best_count == 1 && best->c == prog->regstart))
+	goto theend;
+
+    ret = alloc(best_len + 1);
+    if (ret != NULL)
+    {
+	s = ret;
+	for (state = best; best_count > 0; --best_count, state = state->out)
+	{
+	    if (has_mbyte)
+		s += (*mb_char2bytes)(state->c, s);
+	    else
+		*s++ = state->c;
+	}
+	*s = NUL;
+	*lenp = best_len;
+    }
+
+theend:
+    vim_free(must);
+    vim_free(visited);
+    vim_free(stack);
+    return ret;
+}
+
 /*
  * Allocate more space for post_start.  Called when
  * running above the estimated number of states.
@@ -1461,6 +1601,7 @@ nfa_regatom(void)
 
 		// Previous substitute pattern.
 		// Generated as "\%(pattern\)".
+		reg_used_prev_sub = TRUE;
 		if (reg_prev_sub == NULL)
 		{
 		    emsg(_(e_no_previous_substitute_regular_expression));
@@ -7271,6 +7412,555 @@ nfa_regtry(
     return 1 + rex.lnum;
 }
 
+/*
+ * Lazily built DFA, used to quickly find out that a pattern can't match in a
+ * line.  The states of the DFA are sets of NFA states, only computed when a
+ * character actually takes the DFA from one state to another.  Everything
+ * that does not consume a character is assumed to succeed, except "^" and
+ * "$", thus the DFA may find a match where the NFA doesn't, but never the
+ * other way around.  Submatches are always found with nfa_regmatch().
+ */
+
+// Number of times a program has to be executed before the DFA is used, it
+// is not worth building it for a pattern that is only used once.
+#define NFA_DFA_MIN_USES    2
+
+// Number of times the DFA may be cleared because it uses more than
+// 'maxmempattern' before it is no longer used.
+#define NFA_DFA_MAX_FLUSH   4
+
+#define NFA_DFA_HASHSIZE    256	    // must be a power of two
+
+// What an NFA state does for the DFA.
+#define NFA_DFA_NONE	0	// can't be handled by the DFA
+#define NFA_DFA_EPS	1	// does not consume a character
+#define NFA_DFA_BOL	2	// only at the start of the line
+#define NFA_DFA_EOL	3	// only at the end of the line
+#define NFA_DFA_CHAR	4	// consumes a character
+#define NFA_DFA_MATCH	5	// NFA_MATCH
+
+typedef struct nfa_dstate_S nfa_dstate_T;
+struct nfa_dstate_S
+{
+    nfa_dstate_T *ds_hashnext;	    // next state with the same hash
+    unsigned	ds_hash;
+    int		ds_match;	    // NFA_MATCH is in the set
+    int		ds_eol_match;	    // match at end of line, -1 if unknown
+    nfa_dstate_T *ds_next[256];	    // next state for each character,
+				    // NULL when not computed yet
+    int		ds_len;		    // number of items in ds_ids[]
+    int		ds_ids[1];	    // NFA states, actually longer
+};
+
+struct nfa_dfa_S
+{
+    int		dfa_ic;		    // value of rex.reg_ic for the states
+    int		dfa_flushes;	    // number of times the states were freed
+    long	dfa_size;	    // memory used for states
+    nfa_dstate_T *dfa_start[2];	    // start state, [1] at start of line
+    nfa_dstate_T *dfa_hash[NFA_DFA_HASHSIZE];
+    int		dfa_gen;	    // current value for dfa_mark[]
+    int		*dfa_mark;	    // dfa_gen when NFA state was visited
+    int		*dfa_inset;	    // dfa_gen when NFA state is in the set
+    int		*dfa_stack;	    // for nfa_dfa_closure()
+};
+
+/*
+ * Return what NFA state "c" does in the DFA, one of the NFA_DFA_ values.
+ */
+    static int
+nfa_dfa_kind(int c)
+{
+    if (c >= 0)
+	return NFA_DFA_CHAR;
+    switch (c)
+    {
+	case NFA_MATCH:
+	    return NFA_DFA_MATCH;
+
+	case NFA_BOL:
+	case NFA_BOF:
+	    return NFA_DFA_BOL;
+
+	case NFA_EOL:
+	case NFA_EOF:
+	    return NFA_DFA_EOL;
+
+	case NFA_START_COLL:
+	case NFA_START_NEG_COLL:
+	    return NFA_DFA_CHAR;
+
+	case NFA_SPLIT:
+	case NFA_EMPTY:
+	case NFA_NOPEN:
+	case NFA_NCLOSE:
+	case NFA_ZSTART:
+	case NFA_ZEND:
+	case NFA_BOW:
+	case NFA_EOW:
+	case NFA_CURSOR:
+	case NFA_VISUAL:
+	    return NFA_DFA_EPS;
+    }
+    if (c >= NFA_ANY && c <= NFA_NUPPER_IC)
+	return NFA_DFA_CHAR;
+    if ((c >= NFA_MOPEN && c <= NFA_MCLOSE9)
+#ifdef FEAT_SYN_HL
+	    || (c >= NFA_ZOPEN && c <= NFA_ZCLOSE9)
+#endif
+	    || (c >= NFA_LNUM && c <= NFA_MARK_LT))
+	return NFA_DFA_EPS;
+    return NFA_DFA_NONE;
+}
+
+/*
+ * Return TRUE if the DFA can be used for "prog": there are no back
+ * references, look-around, line breaks or composing characters.
+ */
+    static int
+nfa_dfa_possible(nfa_regprog_T *prog)
+{
+    int		i;
+    nfa_state_T	*state;
+
+    for (i = 0; i < prog->nstate; ++i)
+    {
+	state = &prog->state[i];
+	// States inside a collection are only used by the NFA_START_COLL.
+	if (state->c == NFA_END_COLL || state->c == NFA_RANGE_MIN
+		|| state->c == NFA_RANGE_MAX
+		|| (state->c >= NFA_CLASS_ALNUM && state->c <= NFA_CLASS_FNAME))
+	    continue;
+	if (nfa_dfa_kind(state->c) == NFA_DFA_NONE)
+	    return FALSE;
+    }
+    return TRUE;
+}
+
+/*
+ * Free the states of "dfa".
+ */
+    static void
+nfa_dfa_clear(struct nfa_dfa_S *dfa)
+{
+    int		    i;
+    nfa_dstate_T    *ds;
+
+    for (i = 0; i < NFA_DFA_HASHSIZE; ++i)
+	while (dfa->dfa_hash[i] != NULL)
+	{
+	    ds = dfa->dfa_hash[i];
+	    dfa->dfa_hash[i] = ds->ds_hashnext;
+	    vim_free(ds);
+	}
+    dfa->dfa_start[0] = NULL;
+    dfa->dfa_start[1] = NULL;
+    dfa->dfa_size = 0;
+}
+
+    static void
+nfa_dfa_free(struct nfa_dfa_S *dfa)
+{
+    if (dfa == NULL)
+	return;
+    nfa_dfa_clear(dfa);
+    vim_free(dfa->dfa_mark);
+    vim_free(dfa->dfa_inset);
+    vim_free(dfa->dfa_stack);
+    vim_free(dfa);
+}
+
+/*
+ * Add NFA state "start" and all states that can be reached from it without
+ * consuming a character to the set being built.  "at_bol" and "at_eol" tell
+ * whether "^" and "$" match.  When "$" doesn't match the NFA_EOL state is
+ * added to the set, so that the end of the line can be checked later.
+ */
+    static void
+nfa_dfa_closure(
+    nfa_regprog_T	*prog,
+    struct nfa_dfa_S	*dfa,
+    nfa_state_T		*start,
+    int			at_bol,
+    int			at_eol)
+{
+    int		sp = 0;
+    int		idx;
+    nfa_state_T	*state;
+
+    idx = (int)(start - prog->state);
+    if (dfa->dfa_mark[idx] == dfa->dfa_gen)
+	return;
+    dfa->dfa_mark[idx] = dfa->dfa_gen;
+    dfa->dfa_stack[sp++] = idx;
+    while (sp > 0)
+    {
+	state = &prog->state[dfa->dfa_stack[--sp]];
+	switch (nfa_dfa_kind(state->c))
+	{
+	    case NFA_DFA_BOL:
+		if (!at_bol)
+		    continue;
+		break;
+	    case NFA_DFA_EOL:
+		if (!at_eol)
+		{
+		    dfa->dfa_inset[state - prog->state] = dfa->dfa_gen;
+		    continue;
+		}
+		break;
+	    case NFA_DFA_CHAR:
+	    case NFA_DFA_MATCH:
+		dfa->dfa_inset[state - prog->state] = dfa->dfa_gen;
+		continue;
+	}
+
+	// Follow "out" and for NFA_SPLIT also "out1".
+	if (state->c == NFA_SPLIT && state->out1 != NULL)
+	{
+	    idx = (int)(state->out1 - prog->state);
+	    if (dfa->dfa_mark[idx] != dfa->dfa_gen)
+	    {
+		dfa->dfa_mark[idx] = dfa->dfa_gen;
+		dfa->dfa_stack[sp++] = idx;
+	    }
+	}
+	if (state->out != NULL)
+	{
+	    idx = (int)(state->out - prog->state);
+	    if (dfa->dfa_mark[idx] != dfa->dfa_gen)
+	    {
+		dfa->dfa_mark[idx] = dfa->dfa_gen;
+		dfa->dfa_stack[sp++] = idx;
+	    }
+	}
+    }
+}
+
+/*
+ * Start building a new set of NFA states.
+ */
+    static void
+nfa_dfa_newset(struct nfa_dfa_S *dfa, int state_count)
+{
+    if (++dfa->dfa_gen <= 0)
+    {
+	// wrapped around, clear the marks
+	vim_memset(dfa->dfa_mark, 0, sizeof(int) * state_count);
+	vim_memset(dfa->dfa_inset, 0, sizeof(int) * state_count);
+	dfa->dfa_gen = 1;
+    }
+}
+
+/*
+ * Find or add the DFA state for the set of NFA states that was built with
+ * nfa_dfa_closure().
+ * Returns NULL when out of memory or when the DFA uses more memory than
+ * 'maxmempattern', in which case all states are freed.
+ */
+    static nfa_dstate_T *
+nfa_dfa_addset(nfa_regprog_T *prog, struct nfa_dfa_S *dfa)
+{
+    int		    i;
+    int		    len = 0;
+    unsigned	    hash = 0;
+    int		    match = FALSE;
+    nfa_dstate_T    *ds;
+    size_t	    size;
+
+    for (i = 0; i < prog->nstate; ++i)
+	if (dfa->dfa_inset[i] == dfa->dfa_gen)
+	{
+	    // Store the set in dfa_stack[], it is not used now.
+	    dfa->dfa_stack[len++] = i;
+	    hash = hash * 31 + i;
+	    if (prog->state[i].c == NFA_MATCH)
+		match = TRUE;
+	}
+
+    for (ds = dfa->dfa_hash[hash & (NFA_DFA_HASHSIZE - 1)]; ds != NULL;
+							   ds = ds->ds_hashnext)
+	if (ds->ds_hash == hash && ds->ds_len == len
+		&& memcmp(ds->ds_ids, dfa->dfa_stack, sizeof(int) * len) == 0)
+	    return ds;
+
+    size = sizeof(nfa_dstate_T) + sizeof(int) * (len > 0 ? len - 1 : 0);
+    if ((dfa->dfa_size + (long)size) >> 10 >= p_mmp)
+    {
+	nfa_dfa_clear(dfa);
+	++dfa->dfa_flushes;
+	return NULL;
+    }
+    ds = alloc_clear(size);
+    if (ds == NULL)
+	return NULL;
+    dfa->dfa_size += (long)size;
+    ds->ds_hash = hash;
+    ds->ds_match = match;
+    ds->ds_eol_match = -1;
+    ds->ds_len = len;
+    mch_memmove(ds->ds_ids, dfa->dfa_stack, sizeof(int) * len);
+    ds->ds_hashnext = dfa->dfa_hash[hash & (NFA_DFA_HASHSIZE - 1)];
+    dfa->dfa_hash[hash & (NFA_DFA_HASHSIZE - 1)] = ds;
+    return ds;
+}
+
+/*
+ * Return MAYBE if the character class "class" depends on options, otherwise
+ * TRUE or FALSE for whether it matches "c".
+ */
+    static int
+nfa_dfa_class(int class, int c)
+{
+    if (class == NFA_CLASS_IDENT || class == NFA_CLASS_KEYWORD
+	    || class == NFA_CLASS_FNAME || class == NFA_CLASS_PRINT)
+	return MAYBE;
+    return check_char_class(class, c) == OK;
+}
+
+/*
+ * Return TRUE if NFA state "state" may match character "c", which is not NUL.
+ * This must do the same as nfa_regmatch(), except that character classes
+ * that depend on the buffer or options always match.
+ */
+    static int
+nfa_dfa_char_match(nfa_state_T *state, int c)
+{
+    switch (state->c)
+    {
+	case NFA_START_COLL:
+	case NFA_START_NEG_COLL:
+	  {
+	    nfa_state_T	*item = state->out;
+	    int		maybe = FALSE;
+	    int		r;
+	    int		c1, c2;
+
+	    for ( ; item->c != NFA_END_COLL; item = item->out)
+	    {
+		if (item->c == NFA_RANGE_MIN)
+		{
+		    c1 = item->val;
+		    item = item->out;
+		    c2 = item->val;
+		    if (c >= c1 && c <= c2)
+			break;
+		    if (rex.reg_ic)
+		    {
+			int c_low = MB_CASEFOLD(c);
+
+			for ( ; c1 <= c2; ++c1)
+			    if (MB_CASEFOLD(c1) == c_low)
+				break;
+			if (c1 <= c2)
+			    break;
+		    }
+		}
+		else if (item->c < 0)
+		{
+		    r = nfa_dfa_class(item->c, c);
+		    if (r == TRUE)
+			break;
+		    if (r == MAYBE)
+			maybe = TRUE;
+		}
+		else if (c == item->c
+			     || (rex.reg_ic && MB_CASEFOLD(c)
+						      == MB_CASEFOLD(item->c)))
+		    break;
+	    }
+	    if (item->c != NFA_END_COLL)
+		// one of the items matched
+		return state->c == NFA_START_COLL;
+	    return state->c == NFA_START_NEG_COLL || maybe;
+	  }
+
+	case NFA_ANY:
+	case NFA_IDENT:
+	case NFA_SIDENT:
+	case NFA_KWORD:
+	case NFA_SKWORD:
+	case NFA_FNAME:
+	case NFA_SFNAME:
+	case NFA_PRINT:
+	case NFA_SPRINT:
+	    return TRUE;
+
+	case NFA_WHITE:	    return VIM_ISWHITE(c);
+	case NFA_NWHITE:    return !VIM_ISWHITE(c);
+	case NFA_DIGIT:	    return ri_digit(c);
+	case NFA_NDIGIT:    return !ri_digit(c);
+	case NFA_HEX:	    return ri_hex(c);
+	case NFA_NHEX:	    return !ri_hex(c);
+	case NFA_OCTAL:	    return ri_octal(c);
+	case NFA_NOCTAL:    return !ri_octal(c);
+	case NFA_WORD:	    return ri_word(c);
+	case NFA_NWORD:	    return !ri_word(c);
+	case NFA_HEAD:	    return ri_head(c);
+	case NFA_NHEAD:	    return !ri_head(c);
+	case NFA_ALPHA:	    return ri_alpha(c);
+	case NFA_NALPHA:    return !ri_alpha(c);
+	case NFA_LOWER:	    return ri_lower(c);
+	case NFA_NLOWER:    return !ri_lower(c);
+	case NFA_UPPER:	    return ri_upper(c);
+	case NFA_NUPPER:    return !ri_upper(c);
+	case NFA_LOWER_IC:  return ri_lower(c) || (rex.reg_ic && ri_upper(c));
+	case NFA_NLOWER_IC: return !(ri_lower(c) || (rex.reg_ic && ri_upper(c)));
+	case NFA_UPPER_IC:  return ri_upper(c) || (rex.reg_ic && ri_lower(c));
+	case NFA_NUPPER_IC: return !(ri_upper(c) || (rex.reg_ic && ri_lower(c)));
+    }
+
+    // regular character
+    return state->c == c
+		   || (rex.reg_ic && MB_CASEFOLD(state->c) == MB_CASEFOLD(c));
+}
+
+/*
+ * Compute the DFA state that follows "ds" after character "c".
+ * A match may also start at the next position.
+ * Returns NULL when out of memory or the states were freed.
+ */
+    static nfa_dstate_T *
+nfa_dfa_step(
+    nfa_regprog_T	*prog,
+    struct nfa_dfa_S	*dfa,
+    nfa_dstate_T	*ds,
+    int			c)
+{
+    int		    i;
+    nfa_state_T	    *state;
+    nfa_dstate_T    *next;
+
+    nfa_dfa_newset(dfa, prog->nstate);
+    for (i = 0; i < ds->ds_len; ++i)
+    {
+	state = &prog->state[ds->ds_ids[i]];
+	if (nfa_dfa_kind(state->c) == NFA_DFA_CHAR
+					   && nfa_dfa_char_match(state, c))
+	    nfa_dfa_closure(prog, dfa, state->c == NFA_START_COLL
+				       || state->c == NFA_START_NEG_COLL
+				? state->out1->out : state->out, FALSE, FALSE);
+    }
+    nfa_dfa_closure(prog, dfa, prog->start, FALSE, FALSE);
+
+    next = nfa_dfa_addset(prog, dfa);
+    if (next != NULL && c < 256)
+	ds->ds_next[c] = next;
+    return next;
+}
+
+/*
+ * Return TRUE if DFA state "ds" matches at the end of the line.
+ */
+    static int
+nfa_dfa_eol_match(
+    nfa_regprog_T	*prog,
+    struct nfa_dfa_S	*dfa,
+    nfa_dstate_T	*ds)
+{
+    int		i;
+    nfa_state_T	*state;
+
+    if (ds->ds_eol_match < 0)
+    {
+	nfa_dfa_newset(dfa, prog->nstate);
+	for (i = 0; i < ds->ds_len; ++i)
+	{
+	    state = &prog->state[ds->ds_ids[i]];
+	    if (nfa_dfa_kind(state->c) == NFA_DFA_EOL)
+		// "^" may also match here if the line is empty
+		nfa_dfa_closure(prog, dfa, state->out, TRUE, TRUE);
+	}
+	ds->ds_eol_match = FALSE;
+	for (i = 0; i < prog->nstate; ++i)
+	    if (dfa->dfa_inset[i] == dfa->dfa_gen
+					     && prog->state[i].c == NFA_MATCH)
+		ds->ds_eol_match = TRUE;
+    }
+    return ds->ds_eol_match;
+}
+
+/*
+ * Use the DFA of "prog" to check whether there can be a match in rex.line,
+ * starting at column "col".
+ * Returns FALSE when there is no match, TRUE when there may be a match and
+ * nfa_regtry() must be used.
+ */
+    static int
+nfa_dfa_may_match(nfa_regprog_T *prog, colnr_T col)
+{
+    struct nfa_dfa_S	*dfa = prog->dfa;
+    nfa_dstate_T	*ds;
+    char_u		*p = rex.line + col;
+    int			c;
+    int			len;
+
+    if (dfa == NULL)
+    {
+	dfa = ALLOC_CLEAR_ONE(struct nfa_dfa_S);
+	if (dfa == NULL)
+	    return TRUE;
+	dfa->dfa_mark = ALLOC_CLEAR_MULT(int, prog->nstate);
+	dfa->dfa_inset = ALLOC_CLEAR_MULT(int, prog->nstate);
+	dfa->dfa_stack = ALLOC_MULT(int, prog->nstate);
+	if (dfa->dfa_mark == NULL || dfa->dfa_inset == NULL
+						   || dfa->dfa_stack == NULL)
+	{
+	    nfa_dfa_free(dfa);
+	    return TRUE;
+	}
+	dfa->dfa_ic = rex.reg_ic;
+	prog->dfa = dfa;
+    }
+    else if (dfa->dfa_ic != rex.reg_ic)
+    {
+	// states were computed with another value of 'ignorecase'
+	nfa_dfa_clear(dfa);
+	dfa->dfa_ic = rex.reg_ic;
+    }
+
+    ds = dfa->dfa_start[col == 0];
+    if (ds == NULL)
+    {
+	nfa_dfa_newset(dfa, prog->nstate);
+	nfa_dfa_closure(prog, dfa, prog->start, col == 0, FALSE);
+	ds = nfa_dfa_addset(prog, dfa);
+	dfa->dfa_start[col == 0] = ds;
+    }
+
+    for (;;)
+    {
+	if (ds == NULL || ds->ds_match)
+	    return TRUE;
+	if (ds->ds_len == 0)
+	    // no state left, e.g. after "^" did not match
+	    return FALSE;
+	if (*p == NUL)
+	    return nfa_dfa_eol_match(prog, dfa, ds);
+
+	if (has_mbyte)
+	{
+	    c = (*mb_ptr2char)(p);
+	    len = (*mb_ptr2len)(p);
+	    // The NFA may skip over a composing character separately, leave
+	    // it to the NFA.
+	    if (enc_utf8 && len != utf_ptr2len(p))
+		return TRUE;
+	}
+	else
+	{
+	    c = *p;
+	    len = 1;
+	}
+	p += len;
+
+	if (c < 256 && ds->ds_next[c] != NULL)
+	    ds = ds->ds_next[c];
+	else
+	    ds = nfa_dfa_step(prog, dfa, ds, c);
+    }
+}
+
 /*
  * Match a regexp against a string ("line" points to the string) or multiple
  * lines (if "line" is NULL, use reg_getline()).
@@ -7363,10 +8053,34 @@ nfa_regexec_both(
 	    return find_match_text(col, prog->regstart, prog->match_text);
     }
 
+    // If there is text that must appear, look for it.  When it's not there
+    // there is no match.
+    if (prog->must_text != NULL && !rex.reg_icombine
+	    && reg_find_must(rex.line + col, prog->must_text,
+						     prog->must_len) == NULL)
+	return 0L;
+
     // If the start column is past the maximum column: no need to try.
     if (rex.reg_maxcol > 0 && col >= rex.reg_maxcol)
 	goto theend;
 
+    // When the pattern is used often use the DFA to quickly skip lines
+    // without a match.
+    if (prog->dfa_uses >= 0 && !rex.reg_line_lbr && !rex.reg_icombine)
+    {
+	if (prog->dfa != NULL && prog->dfa->dfa_flushes > NFA_DFA_MAX_FLUSH)
+	{
+	    // the DFA needs too much memory, only use the NFA
+	    nfa_dfa_free(prog->dfa);
+	    prog->dfa = NULL;
+	    prog->dfa_uses = -1;
+	}
+	else if (prog->dfa_uses < NFA_DFA_MIN_USES)
+	    ++prog->dfa_uses;
+	else if (!nfa_dfa_may_match(prog, col))
+	    goto theend;
+    }
+
     // Set the "nstate" used by nfa_regcomp() to zero to trigger an error when
     // it's accidentally used during execution.
     nstate = 0;
@@ -7488,6 +8202,12 @@ nfa_regcomp(char_u *expr, int re_flags)
     prog->reganch = nfa_get_reganch(prog->start, 0);
     prog->regstart = nfa_get_regstart(prog->start, 0);
     prog->match_text = nfa_get_match_text(prog->start);
+    if (prog->match_text == NULL)
+	prog->must_text = nfa_get_must_text(prog, &prog->must_len);
+    else
+	prog->must_text = NULL;
+    prog->dfa = NULL;
+    prog->dfa_uses = nfa_dfa_possible(prog) ? 0 : -1;
 
 #ifdef ENABLE_LOG
     nfa_postfix_dump(expr, OK);
@@ -7527,7 +8247,9 @@ nfa_regfree(regprog_T *prog)
 {
     if (prog != NULL)
     {
+	nfa_dfa_free(((nfa_regprog_T *)prog)->dfa);
 	vim_free(((nfa_regprog_T *)prog)->match_text);
+	vim_free(((nfa_regprog_T *)prog)->must_text);
 	vim_free(((nfa_regprog_T *)prog)->pattern);
 	vim_free(prog);
     }
@@ -2135,6 +2135,16 @@ do_put(
 		    curwin->w_cursor.lnum = lnum;
 		    i = 1;
 		}
+		else if (!(flags & PUT_FIXINDENT))
+		{
+		    // Insert all the lines at once, much faster for many lines.
+		    if (ml_append_bulk(lnum, y_array, y_size, 0) == FAIL)
+			goto error;
+		    new_lnum += y_size;
+		    lnum += y_size;
+		    nr_lines += y_size;
+		    i = y_size;
+		}
 
 		for (; i < y_size; ++i)
 		{
@@ -415,6 +415,71 @@ reset_screen_attr(void)
 	screen_attr = HL_BOLD | HL_UNDERLINE | HL_INVERSE | HL_STRIKETHROUGH;
 }
 
+/*
+ * Called by screen_line() just after the character at "off_to" was output at
+ * screen column "col".  When the next cells up to "endcol" need to be
+ * redrawn with the same character and attributes, and 't_RP' is shorter
+ * than writing them, use 't_RP' to repeat the character.
+ * Returns the number of cells drawn this way.
+ */
+    static int
+screen_line_repeat(
+    unsigned	off_from,
+    unsigned	off_to,
+    int		row,
+    int		col,
+    int		endcol)
+{
+    unsigned	max_off_to = LineOffset[row] + screen_Columns;
+    schar_T	c = ScreenLines[off_to];
+    sattr_T	attr = ScreenAttrs[off_to];
+    int		n;
+    int		i;
+
+    if (c < ' ' || c >= 0x80 || (enc_utf8 && ScreenLinesUC[off_to] != 0)
+	    || screen_attr != attr
+	    || screen_cur_row != row || screen_cur_col != col + 1)
+	return 0;
+
+    // Writing in the last screen cell may scroll the screen.
+    if (*T_XN == NUL && row == screen_Rows - 1 && endcol >= screen_Columns)
+	endcol = screen_Columns - 1;
+
+    for (n = 0; col + n + 1 < endcol; ++n)
+    {
+	i = n + 1;
+	if (ScreenLines[off_from + i] != c
+		|| ScreenAttrs[off_from + i] != attr
+		|| (enc_utf8 && ScreenLinesUC[off_from + i] != 0)
+		|| !char_needs_redraw(off_from + i, off_to + i, 1)
+		// overwriting a double-wide character needs more care
+		|| (has_mbyte && (*mb_off2cells)(off_to + i, max_off_to) > 1)
+		// the bold trick requires redrawing the next character
+		|| (ScreenAttrs[off_to + i] > HL_ALL
+			? (syn_attr2attr(ScreenAttrs[off_to + i]) & HL_BOLD)
+			: (ScreenAttrs[off_to + i] & HL_BOLD))
+		|| pum_under_menu(row, col + i, TRUE)
+#ifdef FEAT_PROP_POPUP
+		|| blocked_by_popup(row, col + i)
+#endif
+		)
+	    break;
+    }
+    if (n <= (int)STRLEN(T_RP))
+	return 0;
+
+    term_repeat_char(n);
+    for (i = 1; i <= n; ++i)
+    {
+	ScreenLines[off_to + i] = c;
+	ScreenAttrs[off_to + i] = attr;
+	if (enc_utf8)
+	    ScreenLinesUC[off_to + i] = 0;
+    }
+    screen_cur_col += n;
+    return n;
+}
+
 /*
  * Move one "cooked" screen line to the screen, but only the characters that
  * have actually changed.  Handle insert/delete character.
@@ -674,7 +739,29 @@ screen_line(
 	    if (enc_dbcs != 0 && char_cells == 2)
 		screen_char_2(off_to, row, col + coloff);
 	    else
+	    {
 		screen_char(off_to, row, col + coloff);
+
+		// A run of the same character may be sent as a repeat count.
+		if (*T_RP != NUL && char_cells == 1 && !force && !p_wiv
+#ifdef FEAT_GUI
+			&& !gui.in_use
+#endif
+			)
+		{
+		    int n = screen_line_repeat(off_from, off_to, row,
+						 col + coloff, endcol + coloff);
+
+		    if (n > 0)
+		    {
+			off_to += n;
+			off_from += n;
+			col += n;
+			redraw_next = char_needs_redraw(off_from + 1, off_to + 1,
+							     endcol - col - 1);
+		    }
+		}
+	    }
 	}
 	else if (  p_wiv
 #ifdef FEAT_GUI
@@ -589,6 +589,11 @@ vim_strchr(char_u *string, int c)
     int		b;
 
     p = string;
+    // Without multibyte characters and for ASCII in UTF-8, where it can't
+    // be part of a multibyte character, use the library function, it is
+    // usually much faster than a loop.
+    if (c > 0 && (has_mbyte ? enc_utf8 && c < 0x80 : c < 0x100))
+	return (char_u *)strchr((char *)p, c);
     if (enc_utf8 && c >= 0x80)
     {
 	while (*p != NUL)
@@ -642,15 +647,9 @@ vim_strchr(char_u *string, int c)
     char_u  *
 vim_strbyte(char_u *string, int c)
 {
-    char_u	*p = string;
-
-    while (*p != NUL)
-    {
-	if (*p == c)
-	    return p;
-	++p;
-    }
-    return NULL;
+    if (c == NUL)
+	return NULL;
+    return (char_u *)strchr((char *)string, c);
 }
 
 /*
@@ -507,6 +507,10 @@ typedef struct mf_hashtab_S
  * The used list is a doubly linked list, most recently used block first.
  *	The blocks in the used list have a block of memory allocated.
  *	mf_used_count is the number of pages in the used list.
+ *	The list has a hot part, blocks that were used more than once, and
+ *	after it a cold part, starting at mf_used_cold.  A block that was
+ *	just read or created goes at the start of the cold part, thus blocks
+ *	that were used only once are released first.
  * The hash lists are used to quickly find a block in the used list.
  * The free list is a single linked list, not sorted.
  *	The blocks in the free list have no block of memory allocated and
@@ -525,7 +529,8 @@ struct block_hdr
 
 #define BH_DIRTY    1
 #define BH_LOCKED   2
-    char	bh_flags;	    // BH_DIRTY or BH_LOCKED
+#define BH_HOT	    4		    // in the hot part of the used list
+    char	bh_flags;	    // BH_DIRTY, BH_LOCKED or BH_HOT
 };
 
 /*
@@ -544,6 +549,59 @@ struct nr_trans
     blocknr_T	nt_new_bnum;		// new, positive, number
 };
 
+/*
+ * A block that was released from the cold part of the used list is
+ * remembered for a while in the ghost list.  When it is used again before it
+ * drops off the list it goes directly into the hot part.
+ */
+typedef struct mf_ghost MF_GHOST;
+
+struct mf_ghost
+{
+    mf_hashitem_T mg_hashitem;		// header for hash table and key
+#define mg_bnum mg_hashitem.mhi_key	// block number
+    MF_GHOST	*mg_next;		// next (newer) item in ghost list
+    MF_GHOST	*mg_prev;		// previous (older) item in ghost list
+};
+
+/*
+ * A block that was released from memory may be kept in memory in compressed
+ * form, so that it does not need to be read back from a file when it is used
+ * again.  The items are in a list with the oldest one first.
+ */
+typedef struct mf_zip MF_ZIP;
+
+struct mf_zip
+{
+    mf_hashitem_T mz_hashitem;		// header for hash table and key
+#define mz_bnum mz_hashitem.mhi_key	// block number
+    MF_ZIP	*mz_next;		// next (newer) item in list
+    MF_ZIP	*mz_prev;		// previous (older) item in list
+    int		mz_page_count;		// number of pages in the block
+    unsigned	mz_size;		// number of bytes in mz_data
+    char_u	mz_data[1];		// compressed block (actually longer)
+};
+
+/*
+ * A data block that was filled when reading a file and was not changed since
+ * then, can be read back from that file.  Such a block can be dropped from
+ * memory without writing it to the swap file.  For each of these blocks there
+ * is an entry in the mf_src list, which has the same structure as the hash
+ * lists.
+ */
+typedef struct mf_src MF_SRC;
+
+struct mf_src
+{
+    mf_hashitem_T ms_hashitem;		// header for hash table and key
+#define ms_bnum ms_hashitem.mhi_key	// negative block number
+
+    off_T	ms_offset;		// offset of the first line in the file
+    long	ms_len;			// number of bytes in the file
+    linenr_T	ms_line_count;		// number of lines in the block
+    int		ms_page_count;		// number of pages in the block
+};
+
 
 typedef struct buffblock buffblock_T;
 typedef struct buffheader buffheader_T;
@@ -690,8 +748,14 @@ struct memfile
     bhdr_T	*mf_free_first;		// first block_hdr in free list
     bhdr_T	*mf_used_first;		// mru block_hdr in used list
     bhdr_T	*mf_used_last;		// lru block_hdr in used list
+    bhdr_T	*mf_used_cold;		// first block_hdr in cold part of used
+					// list, NULL if there is none
     unsigned	mf_used_count;		// number of pages in used list
     unsigned	mf_used_count_max;	// maximum number of pages in memory
+    unsigned	mf_hot_count;		// number of pages in hot part
+    long_u	mf_hits;		// blocks found in memory
+    long_u	mf_misses;		// blocks read from a file
+    long_u	mf_evictions;		// blocks released from memory
     mf_hashtab_T mf_hash;		// hash lists
     mf_hashtab_T mf_trans;		// trans lists
     blocknr_T	mf_blocknr_max;		// highest positive block number + 1
@@ -700,6 +764,22 @@ struct memfile
     blocknr_T	mf_infile_count;	// number of pages in the file
     unsigned	mf_page_size;		// number of bytes in a page
     int		mf_dirty;		// TRUE if there are dirty blocks
+    int		mf_need_flush;		// TRUE if blocks were written since
+					// the file was last flushed to disk
+    int		mf_src_fd;		// file that blocks in mf_src can be
+					// read from, -1 if none
+    mf_hashtab_T mf_src;		// blocks that can be read from mf_src_fd
+    mf_hashtab_T mf_ghost;		// blocks recently released from the
+					// cold part of the used list
+    MF_GHOST	*mf_ghost_first;	// oldest item in ghost list
+    MF_GHOST	*mf_ghost_last;		// newest item in ghost list
+    unsigned	mf_ghost_count;		// number of items in ghost list
+    mf_hashtab_T mf_zip;		// released blocks kept compressed
+    MF_ZIP	*mf_zip_first;		// oldest compressed block
+    MF_ZIP	*mf_zip_last;		// newest compressed block
+    unsigned	mf_zip_count;		// number of compressed blocks
+    long_u	mf_zip_size;		// bytes used for compressed blocks
+    long_u	mf_zip_hits;		// blocks uncompressed instead of read
 #ifdef FEAT_CRYPT
     buf_T	*mf_buffer;		// buffer this memfile is for
     char_u	mf_seed[MF_SEED_LEN];	// seed for encryption
@@ -733,6 +813,10 @@ typedef struct ml_chunksize
 {
     int		mlcs_numlines;
     long	mlcs_totalsize;
+    // The chunks also form a Fenwick tree: these are the sums of the values
+    // above for the chunks from index (i & (i + 1)) up to this one, index i.
+    linenr_T	mlcs_tree_numlines;
+    long	mlcs_tree_totalsize;
 } chunksize_T;
 
 /*
@@ -741,6 +825,7 @@ typedef struct ml_chunksize
 # define ML_CHNK_ADDLINE 1
 # define ML_CHNK_DELLINE 2
 # define ML_CHNK_UPDLINE 3
+# define ML_CHNK_ADDLINE_NOSPLIT 4
 #endif
 
 /*
@@ -770,6 +855,8 @@ typedef struct memline
     linenr_T	ml_locked_low;	// first line in ml_locked
     linenr_T	ml_locked_high;	// last line in ml_locked
     int		ml_locked_lineadd;  // number of lines inserted in ml_locked
+    off_T	ml_src_off;	// offset in the file of the line appended
+				// while reading it, -1 if not known
 #ifdef FEAT_BYTEOFF
     chunksize_T *ml_chunksize;
     int		ml_numchunks;
@@ -1292,21 +1379,6 @@ typedef struct hashitem_S
 // This allows for storing 10 items (2/3 of 16) before a resize is needed.
 #define HT_INIT_SIZE 16
 
-typedef struct hashtable_S
-{
-    long_u	ht_mask;	// mask used for hash value (nr of items in
-				// array is "ht_mask" + 1)
-    long_u	ht_used;	// number of items used
-    long_u	ht_filled;	// number of items used + removed
-    int		ht_changed;	// incremented when adding or removing an item
-    int		ht_locked;	// counter for hash_lock()
-    int		ht_error;	// when set growing failed, can't add more
-				// items before growing works
-    hashitem_T	*ht_array;	// points to the array, allocated when it's
-				// not "ht_smallarray"
-    hashitem_T	ht_smallarray[HT_INIT_SIZE];   // initial array
-} hashtab_T;
-
 typedef long_u hash_T;		// Type for hi_hash
 
 
@@ -1355,6 +1427,21 @@ typedef long_u hash_T;		// Type for hi_hash
 # endif
 #endif
 
+typedef struct hashtable_S
+{
+    long_u	ht_mask;	// mask used for hash value (nr of items in
+				// array is "ht_mask" + 1)
+    long_u	ht_used;	// number of items used
+    long_u	ht_filled;	// number of items used + removed
+    uvarnumber_T ht_changed;	// changed when adding or removing an item
+    int		ht_locked;	// counter for hash_lock()
+    int		ht_error;	// when set growing failed, can't add more
+				// items before growing works
+    hashitem_T	*ht_array;	// points to the array, allocated when it's
+				// not "ht_smallarray"
+    hashitem_T	ht_smallarray[HT_INIT_SIZE];   // initial array
+} hashtab_T;
+
 // On rare systems "char" is unsigned, sometimes we really want a signed 8-bit
 // value.
 typedef signed char int8_T;
@@ -1457,6 +1544,13 @@ typedef struct
     }		vval;
 } typval_T;
 
+// TRUE for a typval that has nothing allocated and can't refer to anything:
+// it can be copied without copy_tv(), overwritten without clear_tv() and
+// needs no marking by the garbage collector.
+#define TV_HAS_NO_ALLOC(tv) ((tv)->v_type == VAR_NUMBER \
+	|| (tv)->v_type == VAR_BOOL || (tv)->v_type == VAR_FLOAT \
+	|| (tv)->v_type == VAR_SPECIAL)
+
 // Values for "dv_scope".
 #define VAR_SCOPE     1	// a:, v:, s:, etc. scope dictionaries
 #define VAR_DEF_SCOPE 2	// l:, g: scope dictionaries: here funcrefs are not
@@ -1515,6 +1609,8 @@ struct listvar_S
     } lv_u;
     type_T	*lv_type;	// current type, allocated by alloc_type()
     list_T	*lv_copylist;	// copied list used by deepcopy()
+    listitem_T	**lv_index;	// pointers to the first "lv_index_len" items,
+				// NULL if not built yet
     list_T	*lv_used_next;	// next list in used lists list
     list_T	*lv_used_prev;	// previous list in used lists list
     int		lv_refcount;	// reference count
@@ -1522,6 +1618,7 @@ struct listvar_S
     int		lv_with_items;	// number of items following this struct that
 				// should not be freed
     int		lv_copyID;	// ID used by deepcopy()
+    int		lv_index_len;	// number of items in "lv_index"
     char	lv_lock;	// zero, VAR_LOCKED, VAR_FIXED
 };
 
@@ -2604,6 +2701,9 @@ typedef struct {
 #ifdef FEAT_SYN_HL
     hashtab_T	b_keywtab;		// syntax keywords hash table
     hashtab_T	b_keywtab_ic;		// idem, ignore case
+    garray_T	b_keytrie;		// trie for b_keywtab, built when
+					// needed
+    garray_T	b_keytrie_ic;		// idem, for b_keywtab_ic
     int		b_syn_error;		// TRUE when error occurred in HL
 # ifdef FEAT_RELTIME
     int		b_syn_slow;		// TRUE when 'redrawtime' reached
@@ -2649,6 +2749,13 @@ typedef struct {
      * b_sst_freecount	number of free entries in b_sst_array[]
      * b_sst_check_lnum	entries after this lnum need to be checked for
      *			validity (MAXLNUM means no check needed)
+     * b_sst_bg_lnum	lines before this one were parsed from the start of
+     *			the buffer, while waiting for a typed character
+     * b_sst_bg_done	after a change entries up to this lnum are correct
+     *			once they have been validated again
+     * b_sst_generation	incremented when a saved state is changed or
+     *			removed, the highlighting of a line with a saved
+     *			state may be different then
      */
     synstate_T	*b_sst_array;
     int		b_sst_len;
@@ -2656,6 +2763,9 @@ typedef struct {
     synstate_T	*b_sst_firstfree;
     int		b_sst_freecount;
     linenr_T	b_sst_check_lnum;
+    linenr_T	b_sst_bg_lnum;
+    linenr_T	b_sst_bg_done;
+    int		b_sst_generation;
     short_u	b_sst_lasttick;	// last display tick
 #endif // FEAT_SYN_HL
 
@@ -3657,6 +3767,11 @@ struct window_S
     int		w_lines_valid;	    // number of valid entries
     wline_T	*w_lines;
 
+    struct linecache_S *w_linecache; // cached screen cells of lines, see
+				    // drawscreen.c; NULL when not used
+    int		w_linecache_size;   // number of entries in w_linecache
+    int		w_linecache_tick;   // incremented to invalidate w_linecache
+
 #ifdef FEAT_FOLDING
     garray_T	w_folds;	    // array of nested folds
     char	w_fold_manual;	    // when TRUE: some folds are opened/closed
@@ -49,6 +49,8 @@ typedef struct syn_pattern
     char	 sp_syncing;		// this item used for syncing
     short	 sp_syn_match_id;	// highlight group ID of pattern
     short	 sp_off_flags;		// see below
+    char_u	 sp_startb[2];		// byte a match starts with, in both
+					// cases; NUL when not known
     int		 sp_offsets[SPO_COUNT];	// offsets
     int		 sp_flags;		// see HL_ defines below
 #ifdef FEAT_CONCEAL
@@ -166,6 +168,23 @@ static keyentry_T dumkey;
 #define HIKEY2KE(p)   ((keyentry_T *)((p) - (dumkey.keyword - (char_u *)&dumkey)))
 #define HI2KE(hi)      HIKEY2KE((hi)->hi_key)
 
+/*
+ * For matching keywords in the text the keywords in b_keywtab and
+ * b_keywtab_ic are also put in a trie, stored in b_keytrie and b_keytrie_ic.
+ * The first item is the root, the children of a node are stored one after
+ * the other, sorted on their byte value.  The trie is built when it is first
+ * used after keywords were added or removed.
+ */
+typedef struct
+{
+    keyentry_T	*kn_kp;		// keywords ending here or NULL
+    int		kn_child;	// index of the first child
+    short	kn_count;	// number of children
+    char_u	kn_byte;	// byte leading to this node
+} keynode_T;
+
+#define KEYNODE(gap, idx) (((keynode_T *)(gap)->ga_data)[idx])
+
 /*
  * To reduce the time spent in keepend(), remember at which level in the state
  * stack the first item with "keepend" is present.  When "-1", there is no
@@ -280,11 +299,22 @@ static short	*current_next_list = NULL; // when non-zero, nextgroup list
 static int	current_next_flags = 0; // flags for current_next_list
 static int	current_line_id = 0;	// unique number for current line
 
+/*
+ * For each byte value the last column in the current line where it appears,
+ * -1 if it does not appear.  Filled once for each line, so that every start
+ * pattern can be skipped with one lookup when the byte a match starts with is
+ * not in the rest of the line.  Only valid when "startb_line_id" is
+ * "current_line_id".
+ */
+static colnr_T	startb_lastcol[256];
+static int	startb_line_id = -1;
+
 #define CUR_STATE(idx)	((stateitem_T *)(current_state.ga_data))[idx]
 
 static void syn_sync(win_T *wp, linenr_T lnum, synstate_T *last_valid);
 static int syn_match_linecont(linenr_T lnum);
 static void syn_start_line(void);
+static synstate_T *syn_stack_update(synstate_T *prev, linenr_T lnum, int dist, int replace);
 static void syn_update_ends(int startofline);
 static void syn_stack_alloc(void);
 static int syn_stack_cleanup(void);
@@ -326,8 +356,12 @@ static void limit_pos_zero(lpos_T *pos, lpos_T *limit);
 static void syn_add_end_off(lpos_T *result, regmmatch_T *regmatch, synpat_T *spp, int idx, int extra);
 static void syn_add_start_off(lpos_T *result, regmmatch_T *regmatch, synpat_T *spp, int idx, int extra);
 static char_u *syn_getcurline(void);
+static void syn_set_startb(synpat_T *spp);
+static int syn_may_start(synpat_T *spp);
 static int syn_regexec(regmmatch_T *rmp, linenr_T lnum, colnr_T col, syn_time_T *st);
 static int check_keyword_id(char_u *line, int startcol, int *endcol, long *flags, short **next_list, stateitem_T *cur_si, int *ccharp);
+static void keytrie_build(hashtab_T *ht, garray_T *gap);
+static keyentry_T *keytrie_find(garray_T *gap, char_u *kwp, int kwlen, int ic);
 static void syn_remove_pattern(synblock_T *block, int idx);
 static void syn_clear_pattern(synblock_T *block, int i);
 static void syn_clear_cluster(synblock_T *block, int i);
@@ -375,8 +409,7 @@ syntax_start(win_T *wp, linenr_T lnum)
     synstate_T	*p;
     synstate_T	*last_valid = NULL;
     synstate_T	*last_min_valid = NULL;
-    synstate_T	*sp, *prev = NULL;
-    linenr_T	parsed_lnum;
+    synstate_T	*prev = NULL;
     linenr_T	first_stored;
     int		dist;
     static varnumber_T changedtick = 0;	// remember the last change ID
@@ -436,7 +469,8 @@ syntax_start(win_T *wp, linenr_T lnum)
 
     /*
      * Try to synchronize from a saved state in b_sst_array[].
-     * Only do this if lnum is not before and not to far beyond a saved state.
+     * Only do this if lnum is not before and not to far beyond a saved state,
+     * or when the lines up to lnum were parsed in the background.
      */
     if (INVALID_STATE(&current_state) && syn_block->b_sst_array != NULL)
     {
@@ -448,7 +482,8 @@ syntax_start(win_T *wp, linenr_T lnum)
 	    if (p->sst_lnum <= lnum && p->sst_change_lnum == 0)
 	    {
 		last_valid = p;
-		if (p->sst_lnum >= lnum - syn_block->b_syn_sync_minlines)
+		if (p->sst_lnum >= lnum - syn_block->b_syn_sync_minlines
+			|| lnum <= syn_block->b_sst_bg_lnum)
 		    last_min_valid = p;
 	    }
 	}
@@ -491,45 +526,7 @@ syntax_start(win_T *wp, linenr_T lnum)
 	// If we parsed at least "minlines" lines or started at a valid
 	// state, the current state is considered valid.
 	if (current_lnum >= first_stored)
-	{
-	    // Check if the saved state entry is for the current line and is
-	    // equal to the current state.  If so, then validate all saved
-	    // states that depended on a change before the parsed line.
-	    if (prev == NULL)
-		prev = syn_stack_find_entry(current_lnum - 1);
-	    if (prev == NULL)
-		sp = syn_block->b_sst_first;
-	    else
-		sp = prev;
-	    while (sp != NULL && sp->sst_lnum < current_lnum)
-		sp = sp->sst_next;
-	    if (sp != NULL
-		    && sp->sst_lnum == current_lnum
-		    && syn_stack_equal(sp))
-	    {
-		parsed_lnum = current_lnum;
-		prev = sp;
-		while (sp != NULL && sp->sst_change_lnum <= parsed_lnum)
-		{
-		    if (sp->sst_lnum <= lnum)
-			// valid state before desired line, use this one
-			prev = sp;
-		    else if (sp->sst_change_lnum == 0)
-			// past saved states depending on change, break here.
-			break;
-		    sp->sst_change_lnum = 0;
-		    sp = sp->sst_next;
-		}
-		load_current_state(prev);
-	    }
-	    // Store the state at this line when it's the first one, the line
-	    // where we start parsing, or some distance from the previously
-	    // saved state.  But only when parsed at least 'minlines'.
-	    else if (prev == NULL
-			|| current_lnum == lnum
-			|| current_lnum >= prev->sst_lnum + dist)
-		prev = store_current_state();
-	}
+	    prev = syn_stack_update(prev, lnum, dist, FALSE);
 
 	// This can take a long time: break when CTRL-C pressed.  The current
 	// state will be wrong then.
@@ -544,6 +541,164 @@ syntax_start(win_T *wp, linenr_T lnum)
     syn_start_line();
 }
 
+/*
+ * Return TRUE when there is a valid saved state for the start of line "lnum"
+ * in window "wp".  The highlighting of the line can then only change with the
+ * text or when b_sst_generation is incremented.
+ */
+    int
+syntax_has_saved_state(win_T *wp, linenr_T lnum)
+{
+    synstate_T	*p;
+
+    FOR_ALL_SYNSTATES(wp->w_s, p)
+    {
+	if (p->sst_lnum == lnum)
+	    return p->sst_change_lnum == 0;
+	if (p->sst_lnum > lnum)
+	    break;
+    }
+    return FALSE;
+}
+
+#if defined(SYN_TIME_LIMIT) || defined(PROTO)
+/*
+ * Return TRUE when there are lines in window "wp" that can be parsed while
+ * waiting for the user to type a character.
+ */
+    int
+syntax_bg_pending(win_T *wp)
+{
+    return syntax_present(wp)
+	    && !wp->w_s->b_syn_slow
+	    && !wp->w_buffer->b_mod_set
+	    && wp->w_buffer->b_ml.ml_mfp != NULL
+	    && wp->w_s->b_sst_bg_lnum < wp->w_buffer->b_ml.ml_line_count;
+}
+
+/*
+ * Parse lines in window "wp" from the start of the buffer, for "msec"
+ * milliseconds, and save the state every so many lines.  When jumping to a
+ * line that was parsed this way syntax_start() does not need to synchronize
+ * and the highlighting is correct.
+ * Continues where the previous call stopped, syn_stack_apply_changes() moves
+ * that back when lines are changed.
+ */
+    void
+syntax_bg_parse(win_T *wp, long msec)
+{
+    proftime_T	tm;
+    proftime_T	syntax_tm;
+    synstate_T	*prev;
+    linenr_T	lnum;
+    int		dist;
+
+    profile_setlimit(msec, &tm);
+    // Like when redrawing, give up on a pattern after 'redrawtime'.
+    profile_setlimit(p_rdt, &syntax_tm);
+    syn_set_timeout(&syntax_tm);
+
+    // Start at the last saved state, without a valid one start at the top.
+    lnum = 1;
+    FOR_ALL_SYNSTATES(wp->w_s, prev)
+    {
+	if (prev->sst_lnum > wp->w_s->b_sst_bg_lnum)
+	    break;
+	if (prev->sst_change_lnum == 0)
+	    lnum = wp->w_s->b_sst_bg_lnum;
+    }
+    syntax_start(wp, lnum);
+    if (syn_block->b_sst_array != NULL && current_lnum == lnum)
+    {
+	if (syn_block->b_sst_len <= Rows)
+	    dist = 999999;
+	else
+	    dist = syn_buf->b_ml.ml_line_count
+					 / (syn_block->b_sst_len - Rows) + 1;
+	prev = syn_stack_find_entry(current_lnum);
+	while (current_lnum < syn_buf->b_ml.ml_line_count)
+	{
+	    (void)syn_finish_line(FALSE);
+	    ++current_lnum;
+
+	    // When a saved state is found to be valid again skip ahead to the
+	    // last one that was valid before a change, not further.
+	    prev = syn_stack_update(prev, syn_block->b_sst_bg_done, dist,
+									TRUE);
+	    syn_start_line();
+	    if (wp->w_s->b_syn_slow || profile_passed_limit(&tm))
+		break;
+	}
+	syn_block->b_sst_bg_lnum = current_lnum;
+	if (syn_block->b_sst_bg_done < current_lnum)
+	    syn_block->b_sst_bg_done = current_lnum;
+    }
+    else
+	// Could not start, don't try again.
+	wp->w_s->b_sst_bg_lnum = wp->w_buffer->b_ml.ml_line_count;
+
+    syn_set_timeout(NULL);
+}
+#endif
+
+/*
+ * Called when the current state is valid for the start of line
+ * "current_lnum", while parsing towards line "lnum".  "prev" is the last
+ * saved state before this line or NULL.
+ * If the saved state for this line is equal to the current state, then
+ * validate all saved states that depended on a change before this line and
+ * load the last one before "lnum".
+ * Otherwise store the current state when it's the first one, the line
+ * where we stop parsing, or "dist" lines from the previously saved state.
+ * When "replace" is TRUE also replace a different saved state for this
+ * line.
+ * Returns the new "prev".
+ */
+    static synstate_T *
+syn_stack_update(
+    synstate_T	*prev,
+    linenr_T	lnum,
+    int		dist,
+    int		replace)
+{
+    synstate_T	*sp;
+    linenr_T	parsed_lnum;
+
+    if (prev == NULL)
+	prev = syn_stack_find_entry(current_lnum - 1);
+    if (prev == NULL)
+	sp = syn_block->b_sst_first;
+    else
+	sp = prev;
+    while (sp != NULL && sp->sst_lnum < current_lnum)
+	sp = sp->sst_next;
+    if (sp != NULL
+	    && sp->sst_lnum == current_lnum
+	    && syn_stack_equal(sp))
+    {
+	parsed_lnum = current_lnum;
+	prev = sp;
+	while (sp != NULL && sp->sst_change_lnum <= parsed_lnum)
+	{
+	    if (sp->sst_lnum <= lnum)
+		// valid state before desired line, use this one
+		prev = sp;
+	    else if (sp->sst_change_lnum == 0)
+		// past saved states depending on change, break here.
+		break;
+	    sp->sst_change_lnum = 0;
+	    sp = sp->sst_next;
+	}
+	load_current_state(prev);
+    }
+    else if (prev == NULL
+	    || current_lnum == lnum
+	    || current_lnum >= prev->sst_lnum + dist
+	    || (replace && sp != NULL && sp->sst_lnum == current_lnum))
+	prev = store_current_state();
+    return prev;
+}
+
 /*
  * We cannot simply discard growarrays full of state_items or buf_states; we
  * have to manually release their extmatch pointers first.
@@ -1052,7 +1207,10 @@ syn_stack_free_block(synblock_T *block)
 	VIM_CLEAR(block->b_sst_array);
 	block->b_sst_first = NULL;
 	block->b_sst_len = 0;
+	++block->b_sst_generation;
     }
+    block->b_sst_bg_lnum = 0;
+    block->b_sst_bg_done = 0;
 }
 /*
  * Free b_sst_array[] for buffer "buf".
@@ -1182,6 +1340,18 @@ syn_stack_apply_changes_block(synblock_T *block, buf_T *buf)
     synstate_T	*p, *prev, *np;
     linenr_T	n;
 
+    // Lines parsed in the background up to the change are still valid.  The
+    // ones below it are valid again once their saved state was validated.
+    if (block->b_sst_bg_done > buf->b_mod_top)
+    {
+	block->b_sst_bg_done += buf->b_mod_xlines;
+	if (block->b_sst_bg_done < buf->b_mod_top)
+	    block->b_sst_bg_done = buf->b_mod_top;
+    }
+    n = buf->b_mod_top - block->b_syn_sync_linebreaks;
+    if (block->b_sst_bg_lnum > n)
+	block->b_sst_bg_lnum = n > 1 ? n : 1;
+
     prev = NULL;
     for (p = block->b_sst_first; p != NULL; )
     {
@@ -1296,6 +1466,7 @@ syn_stack_free_entry(synblock_T *block, synstate_T *p)
     p->sst_next = block->b_sst_firstfree;
     block->b_sst_firstfree = p;
     ++block->b_sst_freecount;
+    ++block->b_sst_generation;
 }
 
 /*
@@ -1405,6 +1576,9 @@ store_current_state(void)
 	    sp->sst_lnum = current_lnum;
 	}
     }
+    else if (!syn_stack_equal(sp))
+	// Overwriting with a different state.
+	++syn_block->b_sst_generation;
     if (sp != NULL)
     {
 	// When overwriting an existing state stack, clear it first
@@ -1956,6 +2130,14 @@ syn_current_attr(
 		    for (idx = syn_block->b_syn_patterns.ga_len; --idx >= 0; )
 		    {
 			spp = &(SYN_ITEMS(syn_block)[idx]);
+
+			// If we already tried matching in this line, and
+			// there isn't a match before next_match_col, skip
+			// this item.
+			if (spp->sp_line_id == current_line_id
+				&& spp->sp_startcol >= next_match_col)
+			    continue;
+
 			if (	   spp->sp_syncing == syncing
 				&& (displaying || !(spp->sp_flags & HL_DISPLAY))
 				&& (spp->sp_type == SPTYPE_MATCH
@@ -1971,11 +2153,7 @@ syn_current_attr(
 			{
 			    int r;
 
-			    // If we already tried matching in this line, and
-			    // there isn't a match before next_match_col, skip
-			    // this item.
-			    if (spp->sp_line_id == current_line_id
-				    && spp->sp_startcol >= next_match_col)
+			    if (!syn_may_start(spp))
 				continue;
 			    spp->sp_line_id = current_line_id;
 
@@ -3154,6 +3332,74 @@ syn_getcurline(void)
     return ml_get_buf(syn_buf, current_lnum, FALSE);
 }
 
+/*
+ * Set sp_startb[] of "spp" from the character a match with its program must
+ * start with.  Only done when it is a single byte, or the first byte of a
+ * UTF-8 character when case is matched.  When ignoring case with UTF-8 a
+ * letter is skipped, since non-ASCII characters may fold to it, e.g. the
+ * Kelvin sign matches "k".
+ */
+    static void
+syn_set_startb(synpat_T *spp)
+{
+    int		ic = FALSE;
+    int		c = vim_regprog_startc(spp->sp_prog, &ic);
+    char_u	buf[MB_MAXBYTES + 1];
+
+    ic = ic || spp->sp_ic;
+    spp->sp_startb[0] = NUL;
+    spp->sp_startb[1] = NUL;
+    if (c > 0 && c < 0x80 && !(ic && enc_utf8 && ASCII_ISALPHA(c)))
+    {
+	spp->sp_startb[0] = ic ? TOLOWER_ASC(c) : c;
+	spp->sp_startb[1] = ic ? TOUPPER_ASC(c) : c;
+    }
+    else if (c >= 0x80 && enc_utf8 && !ic)
+    {
+	(void)utf_char2bytes(c, buf);
+	spp->sp_startb[0] = buf[0];
+	spp->sp_startb[1] = buf[0];
+    }
+}
+
+/*
+ * Return FALSE when start pattern "spp" can't match in the rest of the
+ * current line, because the byte a match starts with is not there.  Then the
+ * pattern is also marked as not matching in this line.
+ */
+    static int
+syn_may_start(synpat_T *spp)
+{
+    char_u	*line;
+    int		lc_col;
+    int		i;
+
+    if (spp->sp_startb[0] == NUL)
+	return TRUE;
+
+    if (startb_line_id != current_line_id)
+    {
+	// Find the last column of every byte with one pass over the line.
+	for (i = 0; i < 256; ++i)
+	    startb_lastcol[i] = -1;
+	line = syn_getcurline();
+	for (i = 0; line[i] != NUL; ++i)
+	    startb_lastcol[line[i]] = i;
+	startb_line_id = current_line_id;
+    }
+
+    lc_col = current_col - spp->sp_offsets[SPO_LC_OFF];
+    if (lc_col < 0)
+	lc_col = 0;
+    if (startb_lastcol[spp->sp_startb[0]] >= lc_col
+	    || startb_lastcol[spp->sp_startb[1]] >= lc_col)
+	return TRUE;
+
+    spp->sp_line_id = current_line_id;
+    spp->sp_startcol = MAXCOL;
+    return FALSE;
+}
+
 /*
  * Call vim_regexec() to find a match with "rmp" in "syn_buf".
  * Returns TRUE when there is a match.
@@ -3242,6 +3488,7 @@ check_keyword_id(
     char_u	keyword[MAXKEYWLEN + 1]; // assume max. keyword len is 80
     hashtab_T	*ht;
     hashitem_T	*hi;
+    garray_T	*gap;
 
     // Find first character after the keyword.  First character was already
     // checked.
@@ -3259,12 +3506,6 @@ check_keyword_id(
     if (kwlen > MAXKEYWLEN)
 	return 0;
 
-    /*
-     * Must make a copy of the keyword, so we can add a NUL and make it
-     * lowercase.
-     */
-    vim_strncpy(keyword, kwp, kwlen);
-
     /*
      * Try twice:
      * 1. matching case
@@ -3275,8 +3516,24 @@ check_keyword_id(
 	ht = round == 1 ? &syn_block->b_keywtab : &syn_block->b_keywtab_ic;
 	if (ht->ht_used == 0)
 	    continue;
-	if (round == 2)	// ignore case
-	    (void)str_foldcase(kwp, kwlen, keyword, MAXKEYWLEN + 1);
+
+	// Find the keywords in the trie, without making a copy of the text.
+	gap = round == 1 ? &syn_block->b_keytrie : &syn_block->b_keytrie_ic;
+	if (gap->ga_len == 0)
+	    keytrie_build(ht, gap);
+	if (gap->ga_len > 0)
+	    kp = keytrie_find(gap, kwp, kwlen, round == 2);
+	else
+	{
+	    // Out of memory, use the hashtable.  Must make a copy of the
+	    // keyword, so we can add a NUL and make it lowercase.
+	    if (round == 1)
+		vim_strncpy(keyword, kwp, kwlen);
+	    else
+		(void)str_foldcase(kwp, kwlen, keyword, MAXKEYWLEN + 1);
+	    hi = hash_find(ht, keyword);
+	    kp = HASHITEM_EMPTY(hi) ? NULL : HI2KE(hi);
+	}
 
 	/*
 	 * Find keywords that match.  There can be several with different
@@ -3285,30 +3542,205 @@ check_keyword_id(
 	 *  Accept a not-contained keyword at toplevel.
 	 *  Accept a keyword at other levels only if it is in the contains list.
 	 */
-	hi = hash_find(ht, keyword);
-	if (!HASHITEM_EMPTY(hi))
-	    for (kp = HI2KE(hi); kp != NULL; kp = kp->ke_next)
-	    {
-		if (current_next_list != 0
-			? in_id_list(NULL, current_next_list, &kp->k_syn, 0)
-			: (cur_si == NULL
-			    ? !(kp->flags & HL_CONTAINED)
-			    : in_id_list(cur_si, cur_si->si_cont_list,
+	for ( ; kp != NULL; kp = kp->ke_next)
+	{
+	    if (current_next_list != 0
+		    ? in_id_list(NULL, current_next_list, &kp->k_syn, 0)
+		    : (cur_si == NULL
+			? !(kp->flags & HL_CONTAINED)
+			: in_id_list(cur_si, cur_si->si_cont_list,
 				      &kp->k_syn, kp->flags & HL_CONTAINED)))
-		{
-		    *endcolp = startcol + kwlen;
-		    *flagsp = kp->flags;
-		    *next_listp = kp->next_list;
+	    {
+		*endcolp = startcol + kwlen;
+		*flagsp = kp->flags;
+		*next_listp = kp->next_list;
 #ifdef FEAT_CONCEAL
-		    *ccharp = kp->k_char;
+		*ccharp = kp->k_char;
 #endif
-		    return kp->k_syn.id;
-		}
+		return kp->k_syn.id;
 	    }
+	}
     }
     return 0;
 }
 
+/*
+ * Add the children of node "idx" to the trie in "gap".  "keys[lo]" to
+ * "keys[hi - 1]" are the sorted keywords below this node, they all start
+ * with the same "depth" bytes.
+ * Returns FAIL when out of memory.
+ */
+    static int
+keytrie_add_children(
+    garray_T	*gap,
+    int		idx,
+    char_u	**keys,
+    int		lo,
+    int		hi,
+    int		depth)
+{
+    int		count = 0;
+    int		child;
+    int		i, n;
+
+    // A keyword that ends here sorts before the ones that continue.
+    if (keys[lo][depth] == NUL)
+	KEYNODE(gap, idx).kn_kp = HIKEY2KE(keys[lo++]);
+
+    for (i = lo; i < hi; ++i)
+	if (i == lo || keys[i][depth] != keys[i - 1][depth])
+	    ++count;
+    if (count == 0)
+	return OK;
+    if (ga_grow(gap, count) == FAIL)
+	return FAIL;
+    child = gap->ga_len;
+    vim_memset(&KEYNODE(gap, child), 0, sizeof(keynode_T) * count);
+    gap->ga_len += count;
+    KEYNODE(gap, idx).kn_child = child;
+    KEYNODE(gap, idx).kn_count = count;
+
+    for (i = lo; i < hi; i = n)
+    {
+	for (n = i + 1; n < hi && keys[n][depth] == keys[i][depth]; ++n)
+	    ;
+	KEYNODE(gap, child).kn_byte = keys[i][depth];
+	if (keytrie_add_children(gap, child, keys, i, n, depth + 1) == FAIL)
+	    return FAIL;
+	++child;
+    }
+    return OK;
+}
+
+/*
+ * Build the trie in "gap" for the keywords in hashtable "ht".
+ * When out of memory "gap" is left empty.
+ */
+    static void
+keytrie_build(hashtab_T *ht, garray_T *gap)
+{
+    char_u	**keys;
+    int		count = 0;
+    long	todo;
+    hashitem_T	*hi;
+
+    ga_clear(gap);
+    ga_init2(gap, sizeof(keynode_T), 100);
+    keys = ALLOC_MULT(char_u *, ht->ht_used);
+    if (keys == NULL)
+	return;
+    todo = (long)ht->ht_used;
+    for (hi = ht->ht_array; todo > 0; ++hi)
+	if (!HASHITEM_EMPTY(hi))
+	{
+	    --todo;
+	    // longer keywords are never found
+	    if (STRLEN(hi->hi_key) <= MAXKEYWLEN)
+		keys[count++] = hi->hi_key;
+	}
+    sort_strings(keys, count);
+
+    if (ga_grow(gap, 1) == FAIL)
+    {
+	vim_free(keys);
+	return;
+    }
+    vim_memset(gap->ga_data, 0, sizeof(keynode_T));
+    gap->ga_len = 1;
+    if (count > 0 && keytrie_add_children(gap, 0, keys, 0, count, 0) == FAIL)
+	ga_clear(gap);
+    vim_free(keys);
+}
+
+/*
+ * Return the node below node "idx" in trie "gap" for byte "c", -1 if there
+ * is none.
+ */
+    static int
+keytrie_child(garray_T *gap, int idx, int c)
+{
+    keynode_T	*np = &KEYNODE(gap, idx);
+    int		lo = np->kn_child;
+    int		hi = lo + np->kn_count;
+    int		mid;
+
+    while (lo < hi)
+    {
+	mid = (lo + hi) / 2;
+	if (KEYNODE(gap, mid).kn_byte < c)
+	    lo = mid + 1;
+	else
+	    hi = mid;
+    }
+    if (lo < np->kn_child + np->kn_count && KEYNODE(gap, lo).kn_byte == c)
+	return lo;
+    return -1;
+}
+
+/*
+ * Find the keywords for "kwp[kwlen]" in trie "gap".  When "ic" is TRUE each
+ * character is made lower case like str_foldcase() does.
+ * Returns NULL when not found.
+ */
+    static keyentry_T *
+keytrie_find(garray_T *gap, char_u *kwp, int kwlen, int ic)
+{
+    int		idx = 0;
+    int		i, j;
+    int		len;
+    int		n;
+    char_u	buf[MB_MAXBYTES + 1];
+    char_u	*p;
+
+    for (i = 0; i < kwlen; i += len)
+    {
+	p = kwp + i;
+	if (!ic)
+	{
+	    len = kwlen - i;
+	    n = len;
+	}
+	else if (enc_utf8)
+	{
+	    int	c = utf_ptr2char(p);
+	    int	olen = utf_ptr2len(p);
+	    int	lc = utf_tolower(c);
+
+	    // Only the first character is changed, composing characters are
+	    // kept.
+	    len = utfc_ptr2len(p);
+	    if ((c < 0x80 || olen > 1) && c != lc)
+	    {
+		n = utf_char2bytes(lc, buf);
+		for (j = 0; j < n; ++j)
+		    if ((idx = keytrie_child(gap, idx, buf[j])) < 0)
+			return NULL;
+		p += olen;
+		n = len - olen;
+	    }
+	    else
+		n = len;
+	}
+	else if (has_mbyte && MB_BYTE2LEN(*p) > 1)
+	{
+	    len = (*mb_ptr2len)(p);
+	    n = len;
+	}
+	else
+	{
+	    len = 1;
+	    buf[0] = TOLOWER_LOC(*p);
+	    p = buf;
+	    n = 1;
+	}
+
+	for (j = 0; j < n; ++j)
+	    if ((idx = keytrie_child(gap, idx, p[j])) < 0)
+		return NULL;
+    }
+    return KEYNODE(gap, idx).kn_kp;
+}
+
 /*
  * Handle ":syntax conceal" command.
  */
@@ -3524,6 +3956,8 @@ syntax_clear(synblock_T *block)
     // free the keywords
     clear_keywtab(&block->b_keywtab);
     clear_keywtab(&block->b_keywtab_ic);
+    ga_clear(&block->b_keytrie);
+    ga_clear(&block->b_keytrie_ic);
 
     // free the syntax patterns
     for (i = block->b_syn_patterns.ga_len; --i >= 0; )
@@ -3746,6 +4180,8 @@ syn_clear_one(int id, int syncing)
     {
 	(void)syn_clear_keyword(id, &curwin->w_s->b_keywtab);
 	(void)syn_clear_keyword(id, &curwin->w_s->b_keywtab_ic);
+	ga_clear(&curwin->w_s->b_keytrie);
+	ga_clear(&curwin->w_s->b_keytrie_ic);
     }
 
     // clear the patterns for "id"
@@ -4476,6 +4912,10 @@ add_keyword(
 	kp->ke_next = HI2KE(hi);
 	hi->hi_key = KE2HIKEY(kp);
     }
+
+    // the trie needs to be built again
+    ga_clear(curwin->w_s->b_syn_ic ? &curwin->w_s->b_keytrie_ic
+						 : &curwin->w_s->b_keytrie);
 }
 
 /*
@@ -5673,6 +6113,7 @@ get_syn_pattern(char_u *arg, synpat_T *ci)
     if (ci->sp_prog == NULL)
 	return NULL;
     ci->sp_ic = curwin->w_s->b_syn_ic;
+    syn_set_startb(ci);
 #ifdef FEAT_PROFILE
     syn_clear_time(&ci->sp_time);
 #endif
@@ -2534,14 +2534,30 @@ termcapinit(char_u *name)
 
 /*
  * The number of calls to ui_write is reduced by using "out_buf".
+ * While the screen is being updated, between out_frame_start() and
+ * out_frame_end(), the buffer grows instead of being flushed when it is full,
+ * up to OUT_FRAME_SIZE bytes, so that a screen update is usually written
+ * with one call.
  */
 #define OUT_SIZE	2047
+#define OUT_FRAME_SIZE	(1024 * 1024)
 
 // add one to allow mch_write() in os_win32.c to append a NUL
-static char_u		out_buf[OUT_SIZE + 1];
+static char_u		out_buf_static[OUT_SIZE + 1];
+static char_u		*out_buf = out_buf_static;
+static int		out_size = OUT_SIZE;	// size of out_buf, minus one
 
 static int		out_pos = 0;	// number of chars in out_buf
 
+static int		out_frame_depth = 0;	// nesting of out_frame_start()
+static int		out_frame_flushed;	// out_flush() called in frame
+static int		out_frame_bs_start;	// out_pos before t_BS
+static int		out_frame_bs_end;	// out_pos after t_BS, -1 if
+						// not sent
+#ifdef FEAT_JOB_CHANNEL
+static long		out_frame_bytes;	// bytes written in frame
+#endif
+
 // Since the maximum number of SGR parameters shown as a normal value range is
 // 16, the escape sequence length can be 4 * 16 + lead + tail.
 #define MAX_ESC_SEQ_LEN	80
@@ -2559,6 +2575,10 @@ out_flush(void)
 	// set out_pos to 0 before ui_write, to avoid recursiveness
 	len = out_pos;
 	out_pos = 0;
+	out_frame_flushed = TRUE;
+#ifdef FEAT_JOB_CHANNEL
+	out_frame_bytes += len;
+#endif
 	ui_write(out_buf, len, FALSE);
 #ifdef FEAT_JOB_CHANNEL
 	if (ch_log_output)
@@ -2576,6 +2596,105 @@ out_flush(void)
     }
 }
 
+/*
+ * Called when "out_buf" does not have room for "len" more bytes: make it
+ * bigger while updating the screen, flush it otherwise.
+ */
+    static void
+out_make_room(int len)
+{
+    int		new_size;
+    char_u	*p;
+
+    if (out_frame_depth > 0 && !p_wd && out_size < OUT_FRAME_SIZE)
+    {
+	new_size = out_size * 2 + 1;
+	if (new_size > OUT_FRAME_SIZE)
+	    new_size = OUT_FRAME_SIZE;
+	p = alloc(new_size + 1);
+	if (p != NULL)
+	{
+	    mch_memmove(p, out_buf, (size_t)out_pos);
+	    if (out_buf != out_buf_static)
+		vim_free(out_buf);
+	    out_buf = p;
+	    out_size = new_size;
+	    if (out_pos + len <= out_size)
+		return;
+	}
+    }
+    out_flush();
+}
+
+/*
+ * Start updating the screen: collect the output until out_frame_end() and
+ * send 't_BS', so that the terminal can show the result all at once.
+ * Calls can be nested.
+ */
+    void
+out_frame_start(void)
+{
+    if (out_frame_depth++ > 0)
+	return;
+    out_frame_flushed = FALSE;
+    out_frame_bs_end = -1;
+#ifdef FEAT_JOB_CHANNEL
+    // output from before the screen update is not counted
+    out_frame_bytes = -out_pos;
+#endif
+    if (*T_BS != NUL && *T_ES != NUL && termcap_active
+#ifdef FEAT_GUI
+	    && !gui.in_use
+#endif
+	    )
+    {
+	out_frame_bs_start = out_pos;
+	out_str(T_BS);
+	if (!out_frame_flushed)
+	    out_frame_bs_end = out_pos;
+	else
+	    // can't take it back
+	    out_frame_bs_end = INT_MAX;
+    }
+}
+
+/*
+ * End updating the screen: send 't_ES' if 't_BS' was sent.  The output is
+ * not flushed here, the cursor is usually positioned next.
+ */
+    void
+out_frame_end(void)
+{
+    if (out_frame_depth == 0 || --out_frame_depth > 0)
+	return;
+    if (out_frame_bs_end >= 0)
+    {
+	if (out_frame_bs_end == out_pos && !out_frame_flushed)
+	    // nothing was drawn, drop the 't_BS'
+	    out_pos = out_frame_bs_start;
+	else
+	    out_str(T_ES);
+    }
+
+    // Go back to the static buffer, outside of a screen update the output
+    // is flushed in small parts.
+    if (out_buf != out_buf_static)
+    {
+	if (out_pos > OUT_SIZE)
+	    out_flush();
+	mch_memmove(out_buf_static, out_buf, (size_t)out_pos);
+	vim_free(out_buf);
+	out_buf = out_buf_static;
+	out_size = OUT_SIZE;
+    }
+#ifdef FEAT_JOB_CHANNEL
+    // Log the number of bytes sent for this screen update, useful to check
+    // how much is sent over a slow connection.
+    if (ch_log_active() && out_frame_bytes + out_pos > 0)
+	ch_log(NULL, "screen update: %ld bytes", out_frame_bytes + out_pos);
+#endif
+}
+
 /*
  * out_flush_cursor(): flush the output buffer and redraw the cursor.
  * Does not flush recursively in the GUI to avoid slow drawing.
@@ -2605,8 +2724,8 @@ out_flush_cursor(
     void
 out_flush_check(void)
 {
-    if (enc_dbcs != 0 && out_pos >= OUT_SIZE - MB_MAXBYTES)
-	out_flush();
+    if (enc_dbcs != 0 && out_pos >= out_size - MB_MAXBYTES)
+	out_make_room(MB_MAXBYTES);
 }
 
 #ifdef FEAT_GUI
@@ -2637,8 +2756,10 @@ out_char(unsigned c)
     out_buf[out_pos++] = c;
 
     // For testing we flush each time.
-    if (out_pos >= OUT_SIZE || p_wd)
+    if (p_wd)
 	out_flush();
+    else if (out_pos >= out_size)
+	out_make_room(1);
 }
 
 /*
@@ -2649,8 +2770,8 @@ out_char_nf(int c)
 {
     out_buf[out_pos++] = (unsigned)c;
 
-    if (out_pos >= OUT_SIZE)
-	out_flush();
+    if (out_pos >= out_size)
+	out_make_room(1);
     return (unsigned)c;
 }
 
@@ -2667,8 +2788,8 @@ out_char_nf(int c)
 out_str_nf(char_u *s)
 {
     // avoid terminal strings being split up
-    if (out_pos > OUT_SIZE - MAX_ESC_SEQ_LEN)
-	out_flush();
+    if (out_pos > out_size - MAX_ESC_SEQ_LEN)
+	out_make_room(MAX_ESC_SEQ_LEN);
 
     while (*s)
 	out_char_nf(*s++);
@@ -2701,8 +2822,8 @@ out_str_cf(char_u *s)
 	    return;
 	}
 #endif
-	if (out_pos > OUT_SIZE - MAX_ESC_SEQ_LEN)
-	    out_flush();
+	if (out_pos > out_size - MAX_ESC_SEQ_LEN)
+	    out_make_room(MAX_ESC_SEQ_LEN);
 #ifdef HAVE_TGETENT
 	for (p = s; *s; ++s)
 	{
@@ -2769,8 +2890,8 @@ out_str(char_u *s)
 	}
 #endif
 	// avoid terminal strings being split up
-	if (out_pos > OUT_SIZE - MAX_ESC_SEQ_LEN)
-	    out_flush();
+	if (out_pos > out_size - MAX_ESC_SEQ_LEN)
+	    out_make_room(MAX_ESC_SEQ_LEN);
 #ifdef HAVE_TGETENT
 	tputs((char *)s, 1, TPUTSFUNCAST out_char_nf);
 #else
@@ -2799,6 +2920,12 @@ term_cursor_right(int i)
     OUT_STR(tgoto((char *)T_CRI, 0, i));
 }
 
+    void
+term_repeat_char(int n)
+{
+    OUT_STR(tgoto((char *)T_RP, 0, n));
+}
+
     void
 term_append_lines(int line_count)
 {
@@ -111,10 +111,13 @@ enum SpecialKey
     KS_SSI,	// save icon text
     KS_SRI,	// restore icon text
     KS_FD,	// disable focus event tracking
-    KS_FE	// enable focus event tracking
+    KS_FE,	// enable focus event tracking
+    KS_CBS,	// begin synchronized update
+    KS_CES,	// end synchronized update
+    KS_CRP	// repeat preceding character number of times
 };
 
-#define KS_LAST	    KS_FE
+#define KS_LAST	    KS_CRP
 
 /*
  * the terminal capabilities are stored in this array
@@ -216,6 +219,9 @@ extern char_u *(term_strings[]);    // current terminal strings
 #define T_SRI	(TERM_STR(KS_SRI))	// restore icon text
 #define T_FD	(TERM_STR(KS_FD))	// disable focus event tracking
 #define T_FE	(TERM_STR(KS_FE))	// enable focus event tracking
+#define T_BS	(TERM_STR(KS_CBS))	// begin synchronized update
+#define T_ES	(TERM_STR(KS_CES))	// end synchronized update
+#define T_RP	(TERM_STR(KS_CRP))	// repeat preceding character
 
 typedef enum {
     TMODE_COOK,	    // terminal mode for external cmds and Ex mode
@@ -163,6 +163,27 @@ func Test_appendbufline_no_E315()
   call delete("Xdone")
 endfunc
 
+" Appending many lines in the middle of the buffer inserts them in bulk.
+func Test_appendbufline_many_lines()
+  new
+  let lines = map(range(1, 5000), {_, v -> repeat('x', v % 300) .. v})
+  call setline(1, lines)
+  call appendbufline('', 2500, lines)
+  call assert_equal(10000, line('$'))
+  call assert_equal(lines[:2499] + lines + lines[2500:], getline(1, '$'))
+  call setbufline('', 9999, lines[:99])
+  call assert_equal(10098, line('$'))
+  call assert_equal(lines[:99], getline(9999, '$'))
+
+  " put a register with the lines
+  silent %d
+  let @a = join(lines, "\n") .. "\n"
+  put a
+  1put a
+  call assert_equal([''] + lines + lines, getline(1, '$'))
+  bwipe!
+endfunc
+
 func Test_deletebufline()
   new
   let b = bufnr('%')
@@ -222,4 +243,19 @@ func Test_appendbufline_redraw()
   call delete('XscriptMatchCommon')
 endfunc
 
+" Byte offsets are correct after appending many lines at once.
+func Test_append_bulk_line2byte()
+  new
+  call setline(1, map(range(1, 1000), 'repeat("x", v:val % 13)'))
+  call append(500, map(range(3000), 'repeat("y", v:val % 17)'))
+  call appendbufline(bufnr(), 10, map(range(2000), 'repeat("z", v:val % 7)'))
+  call append(line('$'), map(range(1500), 'repeat("w", v:val % 5)'))
+  let offsets = [1]
+  for line in getline(1, '$')
+    call add(offsets, offsets[-1] + len(line) + 1)
+  endfor
+  call assert_equal(offsets, map(range(1, line('$') + 1), 'line2byte(v:val)'))
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
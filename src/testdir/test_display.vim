@@ -399,4 +399,140 @@ func Test_display_lastline()
 endfunc
 
 
+" Lines that are displayed again after scrolling may come from the line cache,
+" a change that happened while they were not visible must show up.
+func Test_display_scroll_back_changed()
+  CheckFeature signs
+
+  new
+  10wincmd _
+  setlocal signcolumn=yes
+  call setline(1, range(1, 100)->map('"line " .. v:val'))
+  sign define LineCache text=>>
+  " ScreenLines() uses :redraw!, which does not use the line cache
+  let Row = {r, w -> range(1, w)->map({_, c -> screenstring(r, c)})->join('')}
+  exe 'sign place 2 line=100 name=LineCache buffer=' .. bufnr()
+  normal! gg
+  redraw
+  call assert_equal('  line 2', Row(2, 8))
+
+  exe "normal! 30\<C-E>"
+  redraw
+  exe "normal! 30\<C-Y>"
+  redraw
+  call assert_equal(['  line 2', '  line 3'], [Row(2, 8), Row(3, 8)])
+
+  " sign placed while the line is not visible
+  exe "normal! 30\<C-E>"
+  redraw
+  exe 'sign place 1 line=2 name=LineCache buffer=' .. bufnr()
+  exe "normal! 30\<C-Y>"
+  redraw
+  call assert_equal(['>>line 2', '  line 3'], [Row(2, 8), Row(3, 8)])
+
+  " text changed while the line is not visible
+  exe "normal! 30\<C-E>"
+  redraw
+  call setbufline('%', 3, 'changed')
+  exe "normal! 30\<C-Y>"
+  redraw
+  call assert_equal(['>>line 2', '  changed'], [Row(2, 8), Row(3, 9)])
+
+  exe 'sign unplace * buffer=' .. bufnr()
+  sign undefine LineCache
+  bwipe!
+endfunc
+
+" Screen updates are wrapped in t_BS and t_ES when both are set
+func Test_display_synchronized_update()
+  CheckRunVimInTerminal
+
+  let lines =<< trim END
+    call setline(1, range(1, 200))
+    let &t_BS = "\<Esc>[?2026h"
+    let &t_ES = "\<Esc>[?2026l"
+  END
+  call writefile(lines, 'Xtestsync')
+  let buf = RunVimInTerminal('-S Xtestsync', #{rows: 8})
+  call WaitForAssert({-> assert_equal('1', term_getline(buf, 1))})
+
+  call term_sendkeys(buf, "100\<C-E>")
+  call WaitForAssert({-> assert_equal('101', term_getline(buf, 1))})
+  call assert_equal('107', term_getline(buf, 7))
+
+  call term_sendkeys(buf, "G")
+  call WaitForAssert({-> assert_equal('200', term_getline(buf, 7))})
+
+  call StopVimInTerminal(buf)
+  call delete('Xtestsync')
+endfunc
+
+" A run of the same character is sent with t_RP when it is set
+func Test_display_repeat_char()
+  CheckFeature channel
+
+  new
+  call setline(1, 'empty')
+  redraw
+  let save_rp = &t_RP
+  call ch_logfile('Xlogrepeat', 'w')
+  call setline(1, repeat('x', 60))
+  redraw
+  let &t_RP = "\<Esc>[%db"
+  call setline(1, repeat('y', 60))
+  redraw
+  call ch_logfile('')
+  let &t_RP = save_rp
+
+  let text = join(map(range(1, 61), 'screenstring(1, v:val)'), '')
+  call assert_equal(repeat('y', 60) .. ' ', text)
+
+  let bytes = readfile('Xlogrepeat')
+        \ ->filter({_, l -> l =~ 'screen update: '})
+        \ ->map({_, l -> str2nr(matchstr(l, '\d\+\ze bytes'))})
+  call assert_equal(2, len(bytes))
+  call assert_inrange(60, 999, bytes[0])
+  call assert_inrange(1, 30, bytes[1])
+
+  call delete('Xlogrepeat')
+  bwipe!
+endfunc
+
+" A line highlighted after syncing must be updated from the line cache when
+" the lines above it have been parsed since then.
+func Test_display_scroll_back_syntax()
+  CheckFeature syntax
+
+  new
+  10wincmd _
+  call setline(1, ['/* start'] + repeat(['x = 1;'], 300) + ['*/'])
+  hi LineCacheComment cterm=bold
+  hi LineCacheStatement cterm=underline
+  syn region LineCacheComment start=/\/\*/ end=/\*\//
+  syn match LineCacheStatement /x/
+  syn sync minlines=5 maxlines=5
+  normal! 200Gzt5j
+  redraw
+  " with little syncing the line is wrongly highlighted as a statement
+  let statement_attr = screenattr(2, 1)
+
+  exe "normal! 12\<C-E>"
+  redraw
+  " parsing from the top corrects the saved states
+  for lnum in range(1, line('$'))
+    call synID(lnum, 1, 1)
+  endfor
+  exe "normal! 12\<C-Y>"
+  redraw
+  let attr = screenattr(2, 1)
+  redraw!
+  call assert_equal(screenattr(2, 1), attr)
+  call assert_notequal(statement_attr, attr)
+
+  syn clear
+  hi clear LineCacheComment
+  hi clear LineCacheStatement
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -310,6 +310,21 @@ func Test_fileformat_plusplus_read()
   call assert_fails('e ++abc1 Xfile1', 'E474:')
 endfunc
 
+" Test reading lines with NULs, long lines and lines without NUL or NL
+func Test_fileformat_read_nul_and_long_lines()
+  let lines = ["a\nb\n", repeat("x\n", 5000), repeat('y', 20000), '', "\n"]
+  for ff in ['unix', 'dos']
+    call writefile(ff == 'dos' ? map(copy(lines), 'v:val .. "\r"') : lines,
+          \ 'Xfile1')
+    exe 'e ++ff=' .. ff .. ' Xfile1'
+    w ++ff=unix
+    call assert_equal(lines, readfile('Xfile1'))
+    call assert_equal(lines, getline(1, '$'))
+    bwipe!
+  endfor
+  call delete('Xfile1')
+endfunc
+
 " When Vim starts up with an empty buffer the first item in 'fileformats' is
 " used as the 'fileformat'.
 func Test_fileformat_on_startup()
@@ -1193,6 +1193,44 @@ func Test_byte2line_line2byte()
   bw!
 endfunc
 
+" Test line2byte() and byte2line() with many lines, after changes all over
+" the buffer.
+func Test_byte2line_line2byte_many_lines()
+  new
+  call setline(1, map(range(1, 5000), {_, v -> repeat('a', v % 37)}))
+  let seed = srand(7)
+  for i in range(300)
+    let lnum = rand(seed) % line('$') + 1
+    let what = rand(seed) % 4
+    if what == 0
+      call append(lnum, repeat('b', rand(seed) % 50))
+    elseif what == 1
+      exe lnum .. 'delete'
+    elseif what == 2
+      call setline(lnum, repeat('c', rand(seed) % 80))
+    else
+      exe lnum .. ',' .. min([lnum + 30, line('$')]) .. 'delete'
+      call append(rand(seed) % line('$'),
+            \ map(range(rand(seed) % 900), 'repeat("d", v:val % 20)'))
+    endif
+  endfor
+
+  for ff in ['unix', 'dos']
+    let &fileformat = ff
+    let offsets = [1]
+    for line in getline(1, '$')
+      call add(offsets, offsets[-1] + len(line) + (ff == 'dos' ? 2 : 1))
+    endfor
+    call assert_equal(offsets, map(range(1, line('$') + 1), 'line2byte(v:val)'))
+    call assert_equal(range(1, line('$')),
+          \ map(offsets[: -2], 'byte2line(v:val)'))
+    call assert_equal(range(1, line('$')),
+          \ map(offsets[1 :], 'byte2line(v:val - 1)'))
+  endfor
+  set fileformat&
+  bw!
+endfunc
+
 " Test for byteidx() and byteidxcomp() functions
 func Test_byteidx()
   let a = '.é.' " one char of two bytes
@@ -2682,6 +2720,28 @@ func Test_garbagecollect_now_fails()
   let v:testing = 1
 endfunc
 
+func Test_gcinfo()
+  let gc_count = gcinfo().count
+  let g:gc_list = [repeat([0], 1000), {'a': [1, 2], 'b': 'text'}, 1.5]
+  let l = [1, 2]
+  let l[1] = l
+  unlet l
+  call test_garbagecollect_now()
+
+  let info = gcinfo()
+  call assert_equal(gc_count + 1, info.count)
+  call assert_equal(1, info.freed)
+  " g:gc_list, the list of zeros, the dict and the list in the dict
+  call assert_true(info.marked >= 4)
+  call assert_true(info.scanned >= 1000 + 3 + 2 + 2)
+  call assert_inrange(0, info.maxtime, info.lasttime)
+  call assert_inrange(info.maxtime, info.totaltime, info.totaltime)
+
+  call test_garbagecollect_now()
+  call assert_equal(0, gcinfo().freed)
+  unlet g:gc_list
+endfunc
+
 func Test_echoraw()
   CheckScreendump
 
@@ -379,6 +379,112 @@ func Test_dict_big()
   unlet d
 endfunc
 
+" Freed lists and list items are reused, check they don't keep old values
+func Test_list_reuse_freed()
+  let total = 0
+  for i in range(200)
+    let l = split(repeat('x ', i % 7 + 1))->map({_, v -> v .. i})
+    call assert_equal(i % 7 + 1, len(l))
+    call assert_equal('x' .. i, l[-1])
+    let total += len(filter(copy(l), 'v:val =~ "0$"'))
+    call assert_equal([], l->filter('0'))
+  endfor
+  call assert_equal(79, total)
+
+  let lines =<< trim END
+      var res: list<list<number>>
+      for i in range(50)
+        var tmp = [i, i + 1, i + 2]
+        res->add(tmp->copy()->map((_, v) => v * 2))
+        tmp = []
+      endfor
+      assert_equal([0, 2, 4], res[0])
+      assert_equal([98, 100, 102], res[49])
+  END
+  call v9.CheckDefAndScriptSuccess(lines)
+endfunc
+
+" Indexing a big List in random order, also after changing it
+func Test_list_big_index()
+  let l = repeat([0], 5000)->map({i, _ -> i})
+  for i in range(0, 4999, 7) + range(4998, 0, -13)
+    call assert_equal(i, l[i])
+    call assert_equal(i, l[i - 5000])
+  endfor
+
+  call add(l, 5000)
+  call assert_equal(5000, l[5000])
+  call assert_equal(2500, l[2500])
+  call insert(l, -1, 1000)
+  call assert_equal(999, l[1000 - 1])
+  call assert_equal(-1, l[1000])
+  call assert_equal(3000, l[3001])
+  call remove(l, 10, 2009)
+  call assert_equal(2009, l[10])
+  call assert_equal(4999, l[-2])
+  call assert_equal(4499, l[2500])
+  call assert_equal(2500, index(l, 4499, -2501))
+
+  call reverse(l)
+  call assert_equal(5000, l[0])
+  call assert_equal(0, l[-1])
+  call assert_equal(2009, l[-11])
+  call sort(l, 'n')
+  call assert_equal(0, l[0])
+  call assert_equal(2009, l[10])
+  call assert_equal(5000, l[-1])
+  call filter(l, 'v:val % 2 == 0')
+  call assert_equal(2010, l[5])
+  call assert_equal(4000, l[index(l, 4000)])
+
+  let lines =<< trim END
+      var l: list<number> = range(3000)->copy()->map((_, v) => v)
+      for i in range(0, 2999, 11)
+        assert_equal(i, l[i])
+      endfor
+      l->insert(-1)
+      assert_equal(2998, l[2999])
+      l[1500] = 7
+      assert_equal(7, l[1500])
+  END
+  call v9.CheckDefAndScriptSuccess(lines)
+endfunc
+
+" Copying and extending a big Dictionary makes room for the items at once
+func Test_dict_big_copy_extend()
+  let d = {}
+  for i in range(1500)
+    let d[i] = i * 2
+  endfor
+  for i in range(0, 1499, 3)
+    unlet d[i]
+  endfor
+
+  for c in [copy(d), deepcopy(d), extend({}, d), extendnew({'x': 1}, d)]
+    call assert_equal(1000, len(c) - has_key(c, 'x'))
+    call assert_equal(d, filter(c, 'v:key != "x"'))
+  endfor
+
+  let e = {'2': 'two', '1500': 'new'}
+  call extend(e, d, 'keep')
+  call assert_equal(1001, len(e))
+  call assert_equal(['two', 'new', 2000], [e[2], e[1500], e[1000]])
+  call extend(e, d)
+  call assert_equal(4, e[2])
+  call assert_fails("call extend(e, d, 'error')", 'E737:')
+  call assert_equal(1001, len(e))
+
+  let lines =<< trim END
+      var d = {a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, g: 7, h: 8, i: 9, j: 10,
+               k: 11, l: 12, m: 13, n: 14, o: 15, p: 16, q: 17, r: 18}
+      assert_equal(18, len(d))
+      assert_equal(18, d.r)
+      assert_equal(range(1, 18), values(d)->sort('n'))
+  END
+  call v9.CheckDefAndScriptSuccess(lines)
+  call v9.CheckDefExecAndScriptFailure(['var d = {["a"]: 1, ["a"]: 2}'], 'E721:', 1)
+endfunc
+
 " Dictionary function
 func Test_dict_func()
   let d = {}
@@ -124,7 +124,8 @@ endfunc
 
 func Test_out_of_memory()
   new
-  s/^/,n
+  " The ";" must be in the text, otherwise the line is skipped quickly.
+  s/^/,n;
   " This will be slow...
   call assert_fails('call search("\\v((n||<)+);")', 'E363:')
 endfunc
@@ -1096,4 +1097,125 @@ func Test_using_invalid_visual_position()
   bwipe!
 endfunc
 
+" A pattern used for many lines is first checked with a DFA, the result must
+" be the same as with the backtracking engine.
+func Test_nfa_dfa_many_lines()
+  let pats = ['fo\+', '^foo', 'bar$', '^$', '\<if\>', '[a-c]\+x', '[^a-z]\{3}',
+        \ '\d\+\.\d*', '\s\+$', 'a\|b\|end', '\(ab\)*c', '\%(x\|y\)z', 'x\zsy',
+        \ 'x\zey', '[[:keyword:]]', '[^[:keyword:]]\+', '\k\+(', '\w\+\s*=',
+        \ '\v<(int|char|long)>', '\cFOO', '\CFoo', '[-+]\?\d', '.\{10}$', '^\s*#',
+        \ '\%5cab', '\%>3l.', '\x\x', '\h\w*', '\u\l', '[A-Z]', '[^A-Z]', 'o$\|^o',
+        \ '$', '\%^', '\%$']
+  let lines = ['foo bar', 'if x = 1', '  #include <stdio.h>', 'FOO Foo foo',
+        \ 'abcx bbx', '123.45 + -6', 'trailing   ', '', 'xy yx xyz',
+        \ 'int main(void)', 'o', 'Hello World', 'ABC', 'a', '#define X 1']
+  let seed = srand(7)
+  for i in range(100)
+    let line = ''
+    for j in range(rand(seed) % 20)
+      let line ..= nr2char(char2nr('a') + rand(seed) % 6
+            \ + (rand(seed) % 5 == 0 ? 24 : 0))
+      if rand(seed) % 7 == 0
+        let line ..= ' '
+      endif
+    endfor
+    call add(lines, line)
+  endfor
+
+  new
+  for ic in [0, 1]
+    let &ignorecase = ic
+    for pat in pats
+      let res = []
+      for engine in [1, 2]
+        call setline(1, lines)
+        exe 'silent! %s/\%#=' .. engine .. pat .. '/[&]/g'
+        let found = []
+        exe 'silent! g/\%#=' .. engine .. pat .. '/call add(found, line("."))'
+        call add(res, [getline(1, '$'), found])
+      endfor
+      call assert_equal(res[0], res[1], pat)
+    endfor
+  endfor
+  set ignorecase&
+  bwipe!
+endfunc
+
+" A compiled pattern is kept for when it is used again.  Check that it is not
+" used when an option that changes compiling has a different value.
+func Test_compiled_pattern_reused()
+  for engine in [1, 2]
+    exe 'set regexpengine=' .. engine
+    new
+    call setline(1, ["a\tb", 'c\d', 'tt'])
+    for i in range(2)
+      for [cpo, expected] in [['', [1]], ['l', [2, 3]]]
+        let &cpo = cpo
+        let found = []
+        g/[\t]/call add(found, line('.'))
+        call assert_equal(expected, found)
+      endfor
+    endfor
+    set cpo&
+
+    for i in range(2)
+      setlocal iskeyword=@,48-57,_
+      call assert_equal(0, '-' =~ '^[[:keyword:]]$')
+      setlocal iskeyword+=-
+      call assert_equal(1, '-' =~ '^[[:keyword:]]$')
+    endfor
+    bwipe!
+
+    " The same pattern used recursively.
+    call assert_equal('bbb', substitute('aaa', 'a',
+          \ '\=substitute(submatch(0), "a", "b", "")', 'g'))
+  endfor
+  set regexpengine&
+
+  " An error is given every time.
+  for i in range(2)
+    call assert_fails("call match('x', '\\%#=3x')", 'E864:')
+  endfor
+endfunc
+
+" A pattern with "~" uses the previous substitute string, it must not be
+" reused after the string changed.
+func Test_compiled_pattern_prev_sub()
+  new
+  for engine in [0, 1, 2]
+    exe 'set regexpengine=' .. engine
+    call setline(1, 'qqq')
+    1s/q/x/
+    call assert_equal(1, 'ax' =~ 'a~')
+    call assert_equal(1, 'ax' =~ '\Ma\~')
+    1s/q/y/
+    call assert_equal(1, 'ay' =~ 'a~')
+    call assert_equal(0, 'ax' =~ 'a~')
+    call assert_equal(1, 'ay' =~ '\Ma\~')
+    call assert_equal(0, 'ax' =~ '\Ma\~')
+  endfor
+  set regexpengine&
+  bwipe!
+endfunc
+
+" When the NFA program turns out to be too expensive the backtracking program
+" is used, also when the pattern is compiled again.
+func Test_compiled_pattern_too_expensive()
+  new
+  call setline(1, 'aaac')
+  set regexpengine=0 verbose=1
+  let pat = '\v(a*){1900}b'
+  redir => messages
+  for i in range(3)
+    call assert_equal(0, 'aaac' =~ pat)
+  endfor
+  for i in range(3)
+    call assert_equal(0, search(pat, 'cw'))
+  endfor
+  redir END
+  set regexpengine& verbose&
+  call assert_equal(2, count(messages, 'Switching to backtracking'))
+  bwipe!
+endfunc
+
 " vim: shiftwidth=2 sts=2 expandtab
@@ -568,5 +568,36 @@ func Test_match_too_complicated()
   set regexpengine=0
 endfunc
 
+" Lines without text that every match must contain are skipped quickly, this
+" must not skip lines where the text appears in another case or with
+" multibyte characters.
+func Test_match_required_text()
+  new
+  call setline(1, ['foo', 'bar foo', 'FOO BAR', 'fooü bar',
+        \ 'xx fooéé yy bar', 'ab ab', 'Üfoo', 'foobar'])
+  for engine in [1, 2]
+    exe 'set regexpengine=' .. engine
+    let found = []
+    g/foo.*bar/call add(found, line('.'))
+    call assert_equal([4, 5, 8], found, 'engine ' .. engine)
+    let found = []
+    g/\cfoo.*bar/call add(found, line('.'))
+    call assert_equal([3, 4, 5, 8], found, 'engine ' .. engine)
+    let found = []
+    g/\w\+ü.*b/call add(found, line('.'))
+    call assert_equal([4], found, 'engine ' .. engine)
+    let found = []
+    g/\cü\w\+/call add(found, line('.'))
+    call assert_equal([7], found, 'engine ' .. engine)
+    let found = []
+    g/\d*\(ab\)\+/call add(found, line('.'))
+    call assert_equal([6], found, 'engine ' .. engine)
+    let found = []
+    g/f\%[oo]bar/call add(found, line('.'))
+    call assert_equal([8], found, 'engine ' .. engine)
+  endfor
+  set regexpengine&
+  bwipe!
+endfunc
 
 " vim: shiftwidth=2 sts=2 expandtab
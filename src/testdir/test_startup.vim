@@ -726,6 +726,18 @@ func Test_startuptime()
   call delete('Xtestout')
 endfunc
 
+func Test_startuptime_def_function()
+  CheckFeature startuptime
+  let before = ['def g:StartupFunc(): number', '  return 42', 'enddef',
+	\ 'call g:StartupFunc()']
+  let after = ['qall']
+  if RunVim(before, after, '--startuptime Xtestout')
+    let lines = readfile('Xtestout')
+    call assert_equal(1, len(filter(lines, 'v:val =~ "compiling StartupFunc$"')))
+  endif
+  call delete('Xtestout')
+endfunc
+
 func Test_log()
   CheckFeature channel
 
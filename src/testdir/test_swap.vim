@@ -573,6 +573,159 @@ func Test_swapchoice()
   augroup! test_swapchoice
 endfunc
 
+" Test that unchanged lines of a big file are read back from the file
+func Test_swap_read_lines_from_file()
+  let lines = map(range(1, 20000), {_, v -> 'line ' .. v .. repeat('x', v % 70)})
+  let lines[100] = "with\nNUL"
+  call writefile(lines, 'Xbigfile')
+  let save_mm = &maxmem
+  let save_mmt = &maxmemtot
+  set maxmem=64 maxmemtot=64
+  edit Xbigfile
+  call assert_equal(lines, getline(1, '$'))
+  " unchanged blocks are not in the swap file
+  call assert_true(getfsize(s:swapname()) < getfsize('Xbigfile') / 4)
+
+  call setline(10000, 'changed')
+  let lines[9999] = 'changed'
+  g/5$/d
+  call filter(lines, {_, v -> v !~ '5$'})
+  call assert_equal(lines, getline(1, '$'))
+
+  " overwriting the file must not lose lines
+  write
+  call assert_equal(lines, readfile('Xbigfile'))
+  call assert_equal(lines, getline(1, '$'))
+
+  bwipe!
+  let &maxmem = save_mm
+  let &maxmemtot = save_mmt
+  call delete('Xbigfile')
+endfunc
+
+func Test_memfileinfo()
+  let lines = map(range(1, 20000), {_, v -> 'line ' .. v .. repeat('x', v % 70)})
+  call writefile(lines, 'Xbigfile')
+  let save_mm = &maxmem
+  let save_mmt = &maxmemtot
+  set maxmem=64 maxmemtot=64
+  edit Xbigfile
+  let info = memfileinfo()
+  call assert_equal(64 * 1024 / info.pagesize, info.maxpages)
+  call assert_true(info.pages <= info.maxpages)
+  call assert_true(info.evictions > 0)
+
+  " Lines used repeatedly stay in memory while going over the whole buffer.
+  for i in range(3)
+    call getline(1, 300)
+  endfor
+  let info = memfileinfo()
+  call assert_true(info.hotpages > 0)
+  call getline(1, '$')
+  let hits = memfileinfo().hits
+  let misses = memfileinfo().misses
+  call getline(1, 300)
+  call assert_true(memfileinfo().hits > hits)
+  call assert_equal(misses, memfileinfo().misses)
+
+  call assert_equal({}, memfileinfo(bufnr('$') + 1))
+  bwipe!
+  let &maxmem = save_mm
+  let &maxmemtot = save_mmt
+  call delete('Xbigfile')
+endfunc
+
+" Blocks released from memory are kept compressed and used again.
+func Test_memfileinfo_compressed()
+  let lines = map(range(1, 20000), {_, v -> 'line ' .. v .. repeat('x', v % 70)})
+  call writefile(lines, 'Xbigfile')
+  let save_mm = &maxmem
+  let save_mmt = &maxmemtot
+  set maxmem=64 maxmemtot=1000
+  edit Xbigfile
+  let info = memfileinfo()
+  call assert_true(info.compressed > 0)
+  call assert_true(info.compressedsize <= info.maxpages * info.pagesize / 4)
+  call assert_equal(0, info.compressedhits)
+
+  for i in range(3)
+    call assert_equal(lines[: 1499], getline(1, 1500))
+  endfor
+  let info = memfileinfo()
+  call assert_true(info.compressedhits > 0)
+
+  " Changed blocks are written to the swap file and kept compressed too.
+  1,1500s/x/y/g
+  call map(lines, {i, v -> i < 1500 ? substitute(v, 'x', 'y', 'g') : v})
+  for i in range(3)
+    call assert_equal(lines[: 1499], getline(1, 1500))
+  endfor
+  call assert_true(memfileinfo().compressedhits > info.compressedhits)
+  call assert_equal(lines, getline(1, '$'))
+
+  " Hardly any compressed blocks are kept when at 'maxmemtot'.
+  let compressed = memfileinfo().compressed
+  bwipe!
+  set maxmemtot=64
+  edit Xbigfile
+  call assert_inrange(0, compressed / 4, memfileinfo().compressed)
+
+  bwipe!
+  let &maxmem = save_mm
+  let &maxmemtot = save_mmt
+  call delete('Xbigfile')
+endfunc
+
+" When 'updatecount' is reached while typing the swap file is written but not
+" flushed to disk, that is done for :preserve and after 'updatetime'.
+func Test_swap_sync()
+  new Xswapsync
+  let save_uc = &updatecount
+  let save_sws = &swapsync
+  set updatecount=1 swapsync=fsync
+  let nr = test_getvalue('swap_sync_count')
+  call feedkeys("iswapsyncmarker\<Esc>", 'xt')
+  call assert_match('swapsyncmarker', join(readfile(s:swapname(), 'b'), "\n"))
+  call assert_equal(nr, test_getvalue('swap_sync_count'))
+
+  preserve
+  call assert_equal(nr + 1, test_getvalue('swap_sync_count'))
+  " nothing was written, no need to flush again
+  preserve
+  call assert_equal(nr + 1, test_getvalue('swap_sync_count'))
+  bwipe!
+  let &updatecount = save_uc
+  let &swapsync = save_sws
+
+  CheckRunVimInTerminal
+  let lines =<< trim END
+    set updatetime=50 updatecount=1 swapsync=fsync
+    func Check()
+      call writefile([test_getvalue('swap_sync_count')], 'Xsyncresult')
+    endfunc
+  END
+  call writefile(lines, 'Xswapsyncscript')
+  let buf = RunVimInTerminal('-S Xswapsyncscript Xswapsync', {})
+  call term_sendkeys(buf, "ihello\<Esc>")
+  call WaitForAssert({-> assert_equal(['1'], s:SyncCount(buf))})
+  " waiting again does not flush when nothing was written
+  call assert_equal(['1'], s:SyncCount(buf))
+
+  call StopVimInTerminal(buf)
+  call delete('Xswapsyncscript')
+  call delete('Xsyncresult')
+endfunc
+
+" Get the number of swap file flushes from the Vim in terminal "buf".  First
+" let it wait for a character for longer than 'updatetime'.
+func s:SyncCount(buf)
+  sleep 100m
+  call delete('Xsyncresult')
+  call term_sendkeys(a:buf, ":call Check()\r")
+  call TermWait(a:buf)
+  return filereadable('Xsyncresult') ? readfile('Xsyncresult') : []
+endfunc
+
 func Test_no_swap_file()
   call assert_equal("\nNo swap file", execute('swapname'))
 endfunc
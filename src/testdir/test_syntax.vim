@@ -420,6 +420,105 @@ func Test_syn_sync()
   syn clear
 endfunc
 
+" Ask Vim in terminal "buf" for the syntax item of line 4000.  Called for
+" every attempt of WaitForAssert(), thus an early result doesn't stick.
+func s:SyncResult(buf)
+  call delete('Xsyncresult')
+  call term_sendkeys(a:buf, ":call Check()\r")
+  call TermWait(a:buf)
+  return filereadable('Xsyncresult') ? readfile('Xsyncresult') : []
+endfunc
+
+" While waiting for a character lines are parsed in the background, after
+" that a line far down in a region does not need to be synchronized.
+func Test_syn_sync_background()
+  CheckRunVimInTerminal
+  CheckFeature reltime
+
+  let lines =<< trim END
+    call setline(1, ['/* start'] + repeat(['x = 1;'], 5000) + ['*/', 'y'])
+    syn region Comment start=/\/\*/ end=/\*\//
+    syn match Statement /x/
+    syn sync minlines=10
+    func Check()
+      call writefile([synIDattr(synID(4000, 1, 1), 'name')], 'Xsyncresult')
+    endfunc
+  END
+  call writefile(lines, 'Xsyncbackground')
+  let buf = RunVimInTerminal('-S Xsyncbackground', {})
+
+  call WaitForAssert({-> assert_equal(['Comment'], s:SyncResult(buf))})
+
+  " After a change the lines below it are parsed again.
+  call term_sendkeys(buf, ":2s+.*+*/\r")
+  call WaitForAssert({-> assert_equal(['Statement'], s:SyncResult(buf))})
+  call term_sendkeys(buf, ":2delete\r")
+  call WaitForAssert({-> assert_equal(['Comment'], s:SyncResult(buf))})
+
+  call StopVimInTerminal(buf)
+  call delete('Xsyncbackground')
+  call delete('Xsyncresult')
+endfunc
+
+" Keywords that are a prefix of each other, matching case and ignoring case.
+func Test_syn_keyword_prefix()
+  new
+  call setline(1, 'in int integer INT Integ ÄBC äbc intx')
+  syn keyword Type int integer
+  syn case ignore
+  syn keyword Statement in integ äbc
+  syn case match
+  call assert_equal('Statement', synIDattr(synID(1, 1, 1), 'name'))
+  call assert_equal('Type', synIDattr(synID(1, 4, 1), 'name'))
+  call assert_equal('Type', synIDattr(synID(1, 8, 1), 'name'))
+  call assert_equal('', synIDattr(synID(1, 16, 1), 'name'))
+  call assert_equal('Statement', synIDattr(synID(1, 20, 1), 'name'))
+  call assert_equal('Statement', synIDattr(synID(1, 26, 1), 'name'))
+  call assert_equal('Statement', synIDattr(synID(1, 31, 1), 'name'))
+  call assert_equal('', synIDattr(synID(1, 36, 1), 'name'))
+
+  " after adding and clearing keywords the new ones are used
+  syn keyword Type INT
+  call assert_equal('Type', synIDattr(synID(1, 16, 1), 'name'))
+  syn clear Statement
+  call assert_equal('', synIDattr(synID(1, 1, 1), 'name'))
+  call assert_equal('Type', synIDattr(synID(1, 4, 1), 'name'))
+
+  syn clear
+  bwipe!
+endfunc
+
+" Start patterns are skipped when the character they start with is not in the
+" rest of the line.
+func Test_syn_match_start_char()
+  new
+  call setline(1, ['xx Foo yy bar', 'éa FOO', 'yfoo zf', "x \u212aelvin \u017fin"])
+  syn match Type /foo/
+  syn case ignore
+  syn match Statement /bar/
+  syn match Special /é/
+  syn match Identifier /kelvin/
+  syn match Number /sin/
+  syn case match
+  syn match Constant /y\zsfoo/
+  syn match Comment /zf/lc=1
+  call assert_equal('', synIDattr(synID(1, 4, 1), 'name'))
+  call assert_equal('Statement', synIDattr(synID(1, 11, 1), 'name'))
+  call assert_equal('Special', synIDattr(synID(2, 1, 1), 'name'))
+  call assert_equal('', synIDattr(synID(2, 5, 1), 'name'))
+  call assert_equal('Constant', synIDattr(synID(3, 2, 1), 'name'))
+  call assert_equal('', synIDattr(synID(3, 6, 1), 'name'))
+  call assert_equal('Comment', synIDattr(synID(3, 7, 1), 'name'))
+  " with UTF-8 the Kelvin sign and the long s may fold to "k" and "s", the
+  " start character must not hide a match the regexp engine finds
+  call assert_equal(getline(4) =~? 'kelvin' ? 'Identifier' : '',
+        \ synIDattr(synID(4, 3, 1), 'name'))
+  call assert_equal(getline(4) =~? 'sin' ? 'Number' : '',
+        \ synIDattr(synID(4, 12, 1), 'name'))
+  syn clear
+  bwipe!
+endfunc
+
 func Test_syn_clear()
   syntax keyword Foo foo
   syntax keyword Bar tar
@@ -1570,6 +1570,12 @@ def Test_garbagecollect()
   v9.CheckDefAndScriptFailure(['garbagecollect(20)'], ['E1013: Argument 1: type mismatch, expected bool but got number', 'E1212: Bool required for argument 1'])
 enddef
 
+def Test_gcinfo()
+  var info: dict<number> = gcinfo()
+  assert_true(has_key(info, 'count'))
+  v9.CheckDefAndScriptFailure(['gcinfo(1)'], ['E118: Too many arguments for function: gcinfo', 'E118: Too many arguments for function: gcinfo'])
+enddef
+
 def Test_get()
   v9.CheckDefAndScriptFailure(['get("a", 1)'], ['E1013: Argument 1: type mismatch, expected list<any> but got string', 'E896: Argument of get() must be a List, Dictionary or Blob'])
   [3, 5, 2]->get(1)->assert_equal(5)
@@ -2679,6 +2685,13 @@ def Test_max()
   v9.CheckDefAndScriptFailure(['max(5)'], ['E1013: Argument 1: type mismatch, expected list<any> but got number', 'E1227: List or Dictionary required for argument 1'])
 enddef
 
+def Test_memfileinfo()
+  v9.CheckDefAndScriptFailure(['memfileinfo([])'], ['E1013: Argument 1: type mismatch, expected string but got list<unknown>', 'E1220: String or Number required for argument 1'])
+  assert_equal(['compressed', 'compressedhits', 'compressedsize', 'evictions', 'hits',
+        'hotpages', 'maxpages', 'misses', 'pages', 'pagesize'], memfileinfo()->keys()->sort())
+  assert_equal({}, memfileinfo(bufnr('$') + 1))
+enddef
+
 def Test_menu_info()
   v9.CheckDefAndScriptFailure(['menu_info(10)'], ['E1013: Argument 1: type mismatch, expected string but got number', 'E1174: String required for argument 1'])
   v9.CheckDefAndScriptFailure(['menu_info(10, "n")'], ['E1013: Argument 1: type mismatch, expected string but got number', 'E1174: String required for argument 1'])
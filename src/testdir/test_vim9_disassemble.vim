@@ -1407,6 +1407,100 @@ def Test_disassemble_for_loop()
         instr)
 enddef
 
+def s:WhileLoopOptimized(n: number): number
+  var i = 0
+  var total = 0
+  while i < n
+    if i % 3 == 0
+      total += i
+    else
+      total -= 1
+    endif
+    i += 1
+  endwhile
+  return total
+enddef
+
+def Test_disassemble_while_loop_optimized()
+  assert_equal(12, WhileLoopOptimized(10))
+  assert_equal(0, WhileLoopOptimized(0))
+  var instr = execute('disassemble WhileLoopOptimized')
+  assert_match('WhileLoopOptimized\_s*' ..
+        'var i = 0\_s*' ..
+        'var total = 0\_s*' ..
+        'while i < n\_s*' ..
+        '0 LOAD $0\_s*' ..
+        '1 LOAD arg\[-1\]\_s*' ..
+        '2 COMPARENR_JUMP < -> 16\_s*' ..
+        'if i % 3 == 0\_s*' ..
+        '3 LOAD $0\_s*' ..
+        '4 PUSHNR 3\_s*' ..
+        '5 OPNR %\_s*' ..
+        '6 PUSHNR 0\_s*' ..
+        '7 COMPARENR_JUMP == -> 13\_s*' ..
+        'total += i\_s*' ..
+        '8 LOAD $1\_s*' ..
+        '9 LOAD $0\_s*' ..
+        '10 OPNR +\_s*' ..
+        '11 STORE $1\_s*' ..
+        'else\_s*' ..
+        '12 JUMP -> 14\_s*' ..
+        'total -= 1\_s*' ..
+        '13 ADDNR -1 to $1\_s*' ..
+        'endif\_s*' ..
+        'i += 1\_s*' ..
+        '14 ADDNR 1 to $0\_s*' ..
+        'endwhile\_s*' ..
+        '15 JUMP -> 0\_s*' ..
+        'return total\_s*' ..
+        '16 LOAD $1\_s*' ..
+        '17 RETURN',
+        instr)
+enddef
+
+def s:IfInForLoop(n: number): number
+  var count = 0
+  for i in range(n)
+    if i > 2
+      count += 2
+    else
+      count += 1
+    endif
+  endfor
+  return count
+enddef
+
+def Test_disassemble_jump_to_jump()
+  assert_equal(7, IfInForLoop(5))
+  var instr = execute('disassemble IfInForLoop')
+  assert_match('IfInForLoop\_s*' ..
+        'var count = 0\_s*' ..
+        'for i in range(n)\_s*' ..
+        '0 STORE -1 in $1\_s*' ..
+        '1 LOAD arg\[-1\]\_s*' ..
+        '2 BCALL range(argc 1)\_s*' ..
+        '3 FOR $1 -> 12\_s*' ..
+        '4 STORE $2\_s*' ..
+        'if i > 2\_s*' ..
+        '5 LOAD $2\_s*' ..
+        '6 PUSHNR 2\_s*' ..
+        '7 COMPARENR_JUMP > -> 10\_s*' ..
+        'count += 2\_s*' ..
+        '8 ADDNR 2 to $0\_s*' ..
+        'else\_s*' ..
+        '9 JUMP -> 3\_s*' ..
+        'count += 1\_s*' ..
+        '10 ADDNR 1 to $0\_s*' ..
+        'endif\_s*' ..
+        'endfor\_s*' ..
+        '11 JUMP -> 3\_s*' ..
+        '12 DROP\_s*' ..
+        'return count\_s*' ..
+        '13 LOAD $0\_s*' ..
+        '14 RETURN',
+        instr)
+enddef
+
 def s:ForLoopEval(): string
   var res = ""
   for str in eval('["one", "two"]')
@@ -1952,14 +2046,14 @@ def Test_disassemble_compare()
         ['"text" == isNull', 'COMPARENULL =='],
         ['"text" != isNull', 'COMPARENULL !='],
 
-        ['111 == aNumber', 'COMPARENR =='],
-        ['111 != aNumber', 'COMPARENR !='],
-        ['111 > aNumber', 'COMPARENR >'],
-        ['111 < aNumber', 'COMPARENR <'],
-        ['111 >= aNumber', 'COMPARENR >='],
-        ['111 <= aNumber', 'COMPARENR <='],
-        ['111 =~ aNumber', 'COMPARENR =\~'],
-        ['111 !~ aNumber', 'COMPARENR !\~'],
+        ['111 == aNumber', 'COMPARENR_JUMP =='],
+        ['111 != aNumber', 'COMPARENR_JUMP !='],
+        ['111 > aNumber', 'COMPARENR_JUMP >'],
+        ['111 < aNumber', 'COMPARENR_JUMP <'],
+        ['111 >= aNumber', 'COMPARENR_JUMP >='],
+        ['111 <= aNumber', 'COMPARENR_JUMP <='],
+        ['111 =~ aNumber', 'COMPARENR_JUMP =\~'],
+        ['111 !~ aNumber', 'COMPARENR_JUMP !\~'],
 
         ['"xx" != aString', 'COMPARESTRING !='],
         ['"xx" > aString', 'COMPARESTRING >'],
@@ -2039,8 +2133,7 @@ def Test_disassemble_compare()
         'if ' .. substitute(case[0], '[[~]', '\\\0', 'g') .. '.*' ..
         '\d \(PUSH\|FUNCREF\).*' ..
         '\d \(PUSH\|FUNCREF\|LOAD\).*' ..
-        '\d ' .. case[1] .. '.*' ..
-        '\d JUMP_IF_FALSE -> \d\+.*',
+        '\d ' .. case[1] .. '\( -> \|.*\d JUMP_IF_FALSE -> \)\d\+.*',
         instr)
 
     nr += 1
@@ -2552,6 +2552,96 @@ def Test_interrupt_loop()
   getchar(0)
 enddef
 
+def Test_error_after_simple_instructions()
+  var x = 0
+  var y = 0
+  var caught = 0
+  while x < 10
+    try
+      x += 1
+      y = 10 / (x % 3)
+    catch /E1154:/
+      caught += 1
+    endtry
+  endwhile
+  assert_equal(10, x)
+  assert_equal(10, y)
+  assert_equal(3, caught)
+enddef
+
+def Test_load_store_local_values()
+  const c = 3
+  var n = c
+  n += 1
+  var s = 'x'
+  var l = [c, n, s]
+  l[0] = 7
+  for i in range(3)
+    s ..= string(n * i)
+    n = i
+  endfor
+  assert_equal([7, 4, 'x'], l)
+  assert_equal('x002', s)
+  assert_equal(2, n)
+
+  var b = true
+  b = !b
+  assert_equal(false, b)
+  if has('float')
+    var f = 1.5
+    f = f * 2
+    assert_equal(3.0, f)
+  endif
+enddef
+
+def s:LoadCachedItems(d: dict<any>): list<any>
+  return [g:cached_var, b:cached_var, d.key]
+enddef
+
+def Test_load_cached_items()
+  g:cached_var = 1
+  b:cached_var = 'one'
+  var d: dict<any> = {key: 'a'}
+  for i in range(3)
+    assert_equal([1, 'one', 'a'], LoadCachedItems(d))
+  endfor
+
+  # a changed value is used
+  g:cached_var = 2
+  d.key = 'b'
+  assert_equal([2, 'one', 'b'], LoadCachedItems(d))
+
+  # removing the item and adding it back after resizing the hashtab
+  unlet g:cached_var
+  remove(d, 'key')
+  for i in range(30)
+    d['other' .. i] = i
+  endfor
+  g:cached_var = 3
+  d.key = 'c'
+  assert_equal([3, 'one', 'c'], LoadCachedItems(d))
+
+  # another dict with the same key
+  for i in range(3)
+    assert_equal([3, 'one', 'x' .. i], LoadCachedItems({key: 'x' .. i}))
+  endfor
+
+  # another buffer has its own b: variables
+  new
+  b:cached_var = 'two'
+  assert_equal([3, 'two', 'c'], LoadCachedItems(d))
+  bwipe!
+  assert_equal([3, 'one', 'c'], LoadCachedItems(d))
+
+  unlet g:cached_var
+  try
+    LoadCachedItems(d)
+    assert_report('should have failed')
+  catch /E121:/
+  endtry
+  unlet b:cached_var
+enddef
+
 def Test_automatic_line_continuation()
   var mylist = [
       'one',
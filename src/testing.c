@@ -974,6 +974,8 @@ f_test_getvalue(typval_T *argvars, typval_T *rettv)
 
 	if (STRCMP(name, (char_u *)"need_fileinfo") == 0)
 	    rettv->vval.v_number = need_fileinfo;
+	else if (STRCMP(name, (char_u *)"swap_sync_count") == 0)
+	    rettv->vval.v_number = swap_sync_count;
 	else
 	    semsg(_(e_invalid_argument_str), name);
     }
@@ -275,6 +275,9 @@ inchar_loop(
     int		interrupted = FALSE;
     int		did_call_wait_func = FALSE;
     int		did_start_blocking = FALSE;
+#ifdef SYN_TIME_LIMIT
+    int		did_syntax = FALSE;
+#endif
     long	wait_time;
     long	elapsed_time = 0;
 #ifdef ELAPSED_FUNC
@@ -378,6 +381,18 @@ inchar_loop(
 	    wait_time = 100L;
 #endif
 
+#ifdef SYN_TIME_LIMIT
+	// While waiting for the user parse syntax further down in the buffer,
+	// in small steps, and only check for a character in between.
+	did_syntax = FALSE;
+	if (wtime < 0 && wait_time != 0 && syntax_bg_pending(curwin))
+	{
+	    syntax_bg_parse(curwin, 10L);
+	    did_syntax = TRUE;
+	    wait_time = 0L;
+	}
+#endif
+
 	// Wait for a character to be typed or another event, such as the winch
 	// signal or an event on the monitored file descriptors.
 	did_call_wait_func = TRUE;
@@ -413,6 +428,9 @@ inchar_loop(
 		|| interrupted
 #endif
 		|| wait_time > 0
+#ifdef SYN_TIME_LIMIT
+		|| did_syntax
+#endif
 		|| (wtime < 0 && !did_start_blocking))
 	    // no character available, but something to be done, keep going
 	    continue;
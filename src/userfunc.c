@@ -3112,7 +3112,7 @@ delete_script_functions(int sid)
 		fp = HI2UF(hi);
 		if (STRNCMP(fp->uf_name, buf, len) == 0)
 		{
-		    int changed = func_hashtab.ht_changed;
+		    uvarnumber_T changed = func_hashtab.ht_changed;
 
 		    fp->uf_flags |= FC_DEAD;
 
@@ -3146,7 +3146,7 @@ free_all_functions(void)
     ufunc_T	*fp;
     long_u	skipped = 0;
     long_u	todo = 1;
-    int		changed;
+    uvarnumber_T changed;
 
     // Clean up the current_funccal chain and the funccal stack.
     while (current_funccal != NULL)
@@ -4173,7 +4173,7 @@ save_function_name(
     void
 list_functions(regmatch_T *regmatch)
 {
-    int		changed = func_hashtab.ht_changed;
+    uvarnumber_T changed = func_hashtab.ht_changed;
     long_u	todo = func_hashtab.ht_used;
     hashitem_T	*hi;
 
@@ -4983,7 +4983,7 @@ ex_function(exarg_T *eap)
 ex_defcompile(exarg_T *eap UNUSED)
 {
     long	todo = (long)func_hashtab.ht_used;
-    int		changed = func_hashtab.ht_changed;
+    uvarnumber_T changed = func_hashtab.ht_changed;
     hashitem_T	*hi;
     ufunc_T	*ufunc;
 
@@ -5103,7 +5103,7 @@ get_expanded_name(char_u *name, int check)
 get_user_func_name(expand_T *xp, int idx)
 {
     static long_u	done;
-    static int		changed;
+    static uvarnumber_T changed;
     static hashitem_T	*hi;
     ufunc_T		*fp;
 
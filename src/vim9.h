@@ -35,11 +35,11 @@ typedef enum {
     // get and set variables
     ISN_LOAD,	    // push local variable isn_arg.number
     ISN_LOADV,	    // push v: variable isn_arg.number
-    ISN_LOADG,	    // push g: variable isn_arg.string
+    ISN_LOADG,	    // push g: variable isn_arg.loadname
     ISN_LOADAUTO,   // push g: autoload variable isn_arg.string
-    ISN_LOADB,	    // push b: variable isn_arg.string
-    ISN_LOADW,	    // push w: variable isn_arg.string
-    ISN_LOADT,	    // push t: variable isn_arg.string
+    ISN_LOADB,	    // push b: variable isn_arg.loadname
+    ISN_LOADW,	    // push w: variable isn_arg.loadname
+    ISN_LOADT,	    // push t: variable isn_arg.loadname
     ISN_LOADGDICT,  // push g: dict
     ISN_LOADBDICT,  // push b: dict
     ISN_LOADWDICT,  // push w: dict
@@ -70,6 +70,8 @@ typedef enum {
     // ISN_STOREOTHER, // pop into other script variable isn_arg.other.
 
     ISN_STORENR,    // store number into local variable isn_arg.storenr.stnr_idx
+    ISN_ADDNR,	    // add number isn_arg.storenr.stnr_val to local variable
+		    // isn_arg.storenr.stnr_idx
     ISN_STOREINDEX,	// store into list or dictionary, type isn_arg.vartype,
 			// value/index/variable on stack
     ISN_STORERANGE,	// store into blob,
@@ -117,6 +119,8 @@ typedef enum {
     ISN_JUMP,	    // jump if condition is matched isn_arg.jump
     ISN_JUMP_IF_ARG_SET, // jump if argument is already set, uses
 			 // isn_arg.jumparg
+    ISN_COMPARENR_JUMP, // compare two numbers and jump if false, uses
+			// isn_arg.cmpjump
 
     // loop
     ISN_FOR,	    // get next item from a list, uses isn_arg.forloop
@@ -166,7 +170,7 @@ typedef enum {
     ISN_BLOBAPPEND, // append to a blob, like add()
     ISN_GETITEM,    // push list item, isn_arg.number is the index
     ISN_MEMBER,	    // dict[member]
-    ISN_STRINGMEMBER, // dict.member using isn_arg.string
+    ISN_STRINGMEMBER, // dict.member using isn_arg.loadname
     ISN_2BOOL,	    // falsy/truthy to bool, uses isn_arg.tobool
     ISN_COND2BOOL,  // convert value to bool
     ISN_2STRING,    // convert value to string at isn_arg.tostring on stack
@@ -229,6 +233,21 @@ typedef struct {
     int	    cuf_argcount;   // number of arguments on top of stack
 } cufunc_T;
 
+// Cache for looking up an item in a hashtab: when "ic_ht" is the table and
+// its "ht_changed" is still "ic_changed" then "ic_di" is the item.
+typedef struct {
+    hashtab_T	*ic_ht;
+    uvarnumber_T ic_changed;
+    dictitem_T	*ic_di;
+} itemcache_T;
+
+// arguments to ISN_LOADG, ISN_LOADB, ISN_LOADW, ISN_LOADT and
+// ISN_STRINGMEMBER
+typedef struct {
+    char_u	*ln_name;	// variable name or dict key
+    itemcache_T	*ln_cache;	// allocated when first found, or NULL
+} loadname_T;
+
 // arguments to ISN_GETITEM
 typedef struct {
     varnumber_T	gi_index;
@@ -293,6 +312,12 @@ typedef struct {
     int		op_ic;	    // TRUE with '#', FALSE with '?', else MAYBE
 } opexpr_T;
 
+// arguments to ISN_COMPARENR_JUMP
+typedef struct {
+    opexpr_T	cj_op;		    // comparison, as for ISN_COMPARENR
+    int		cj_where;	    // position to jump to when false
+} cmpjump_T;
+
 // arguments to ISN_CHECKTYPE
 typedef struct {
     type_T	*ct_type;
@@ -438,6 +463,7 @@ struct isn_S {
 	partial_T	    *partial;
 	jump_T		    jump;
 	jumparg_T	    jumparg;
+	cmpjump_T	    cmpjump;
 	forloop_T	    forloop;
 	try_T		    tryref;
 	trycont_T	    trycont;
@@ -467,6 +493,7 @@ struct isn_S {
 	tostring_T	    tostring;
 	tobool_T	    tobool;
 	getitem_T	    getitem;
+	loadname_T	    loadname;
 	debug_T		    debug;
     } isn_arg;
 };
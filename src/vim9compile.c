@@ -2593,6 +2593,10 @@ compile_def_function(
     int		prof_lnum = -1;
 #endif
     int		debug_lnum = -1;
+#ifdef STARTUPTIME
+    struct timeval	tv_rel;
+    struct timeval	tv_start;
+#endif
 
     // allocated lines are freed at the end
     ga_init2(&lines_to_free, sizeof(char_u *), 50);
@@ -2635,6 +2639,11 @@ compile_def_function(
 
     ufunc->uf_def_status = UF_COMPILING;
 
+#ifdef STARTUPTIME
+    if (time_fd != NULL)
+	time_push(&tv_rel, &tv_start);
+#endif
+
     CLEAR_FIELD(cctx);
 
     cctx.ctx_compile_type = compile_type;
@@ -3254,6 +3263,8 @@ nextline:
 	generate_instr(&cctx, ISN_RETURN_VOID);
     }
 
+    optimize_instructions(instr);
+
     // When compiled with ":silent!" and there was an error don't consider the
     // function compiled.
     if (emsg_silent == 0 || did_emsg_silent == did_emsg_silent_before)
@@ -3339,6 +3350,17 @@ erret:
     ga_clear_strings(&lines_to_free);
     free_locals(&cctx);
     ga_clear(&cctx.ctx_type_stack);
+
+#ifdef STARTUPTIME
+    if (time_fd != NULL)
+    {
+	vim_snprintf((char *)IObuff, IOSIZE, "compiling %s%s",
+			    printable_func_name(ufunc),
+			    ret == OK ? "" : " (failed)");
+	time_msg((char *)IObuff, &tv_start);
+	time_pop(&tv_rel);
+    }
+#endif
     return ret;
 }
 
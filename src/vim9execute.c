@@ -104,6 +104,30 @@ static garray_T profile_info_ga = {0, 0, sizeof(profinfo_T), 20, NULL};
 // Get pointer to item relative to the bottom of the stack, -1 is the last one.
 #define STACK_TV_BOT(idx) (((typval_T *)ectx->ec_stack.ga_data) + ectx->ec_stack.ga_len + (idx))
 
+/*
+ * With GCC and clang the address of a label can be stored.  That is used in
+ * exec_instructions() to jump from the end of a simple instruction straight
+ * to the code for the next one, instead of going back to the top of the loop
+ * and through the big switch.  NEXT_INSTR may only be used after an
+ * instruction that did not give an error or throw an exception, since the
+ * checks for that at the top of the loop are skipped.  Jumping back must go
+ * through the top of the loop, so that CTRL-C is noticed.
+ * INSTR_LABEL() defines the label for an instruction that can be jumped to,
+ * "exec_label[]" has the label to use for each instruction type.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(PROTO)
+# define USE_LABELS_AS_VALUES
+# define NEXT_INSTR \
+    { \
+	iptr = &ectx->ec_instr[ectx->ec_iidx++]; \
+	goto *exec_label[iptr->isn_type]; \
+    }
+# define INSTR_LABEL(label) label:
+#else
+# define NEXT_INSTR break
+# define INSTR_LABEL(label)
+#endif
+
     void
 to_string_error(vartype_T vartype)
 {
@@ -169,23 +193,33 @@ exe_newdict(int count, ectx_T *ectx)
     char_u	*key;
     int		idx;
     typval_T	*tv;
+    hashtab_T	*ht;
+    hashitem_T	*hi;
+    hash_T	hash;
+    int		locked;
 
     if (count >= 0)
     {
 	dict = dict_alloc();
 	if (unlikely(dict == NULL))
 	    return FAIL;
+	ht = &dict->dv_hashtab;
+	// Make room for all items at once.
+	locked = hash_lock_add(ht, count) == OK;
 	for (idx = 0; idx < count; ++idx)
 	{
 	    // have already checked key type is VAR_STRING
 	    tv = STACK_TV_BOT(2 * (idx - count));
-	    // check key is unique
+	    // check key is unique, "hi" is where the item is to be added
 	    key = tv->vval.v_string == NULL
 				? (char_u *)"" : tv->vval.v_string;
-	    item = dict_find(dict, key, -1);
-	    if (item != NULL)
+	    hash = hash_hash(key);
+	    hi = hash_lookup(ht, key, hash);
+	    if (!HASHITEM_EMPTY(hi))
 	    {
 		semsg(_(e_duplicate_key_in_dicitonary), key);
+		if (locked)
+		    hash_unlock(ht);
 		dict_unref(dict);
 		return MAYBE;
 	    }
@@ -193,6 +227,8 @@ exe_newdict(int count, ectx_T *ectx)
 	    clear_tv(tv);
 	    if (unlikely(item == NULL))
 	    {
+		if (locked)
+		    hash_unlock(ht);
 		dict_unref(dict);
 		return FAIL;
 	    }
@@ -200,13 +236,17 @@ exe_newdict(int count, ectx_T *ectx)
 	    item->di_tv = *tv;
 	    item->di_tv.v_lock = 0;
 	    tv->v_type = VAR_UNKNOWN;
-	    if (dict_add(dict, item) == FAIL)
+	    if (hash_add_item(ht, hi, item->di_key, hash) == FAIL)
 	    {
 		// can this ever happen?
+		if (locked)
+		    hash_unlock(ht);
 		dict_unref(dict);
 		return FAIL;
 	    }
 	}
+	if (locked)
+	    hash_unlock(ht);
     }
 
     if (count > 0)
@@ -2373,11 +2413,51 @@ execute_for(isn_T *iptr, ectx_T *ectx)
 }
 
 /*
- * Load instruction for w:/b:/g:/t: variable.
+ * Find item "name" in hashtab "ht".
+ * When "cachep" is not NULL it is used to remember where the item was found,
+ * so that the next lookup in the same, unchanged hashtab is just a check.
+ * Returns NULL if not found.
+ */
+    static dictitem_T *
+find_item_cached(hashtab_T *ht, char_u *name, itemcache_T **cachep)
+{
+    itemcache_T	*ic = cachep == NULL ? NULL : *cachep;
+    hashitem_T	*hi;
+
+    // "ht_changed" is unique for every change of any hashtab, thus the item
+    // can't have been removed or the hashtab freed and allocated again.
+    if (ic != NULL && ic->ic_ht == ht && ic->ic_changed == ht->ht_changed)
+	return ic->ic_di;
+
+    hi = hash_find(ht, name);
+    if (HASHITEM_EMPTY(hi))
+	return NULL;
+    if (cachep != NULL)
+    {
+	if (ic == NULL)
+	    ic = *cachep = ALLOC_ONE(itemcache_T);
+	if (ic != NULL)
+	{
+	    ic->ic_ht = ht;
+	    ic->ic_changed = ht->ht_changed;
+	    ic->ic_di = HI2DI(hi);
+	}
+    }
+    return HI2DI(hi);
+}
+
+/*
+ * Load instruction for w:/b:/g:/t: variable "name".
  * "isn_type" is used instead of "iptr->isn_type".
+ * "cachep" is passed to find_item_cached(), can be NULL.
  */
     static int
-load_namespace_var(ectx_T *ectx, isntype_T isn_type, isn_T *iptr)
+load_namespace_var(
+	ectx_T	    *ectx,
+	isntype_T   isn_type,
+	isn_T	    *iptr,
+	char_u	    *name,
+	itemcache_T **cachep)
 {
     dictitem_T	*di = NULL;
     hashtab_T	*ht = NULL;
@@ -2406,13 +2486,13 @@ load_namespace_var(ectx_T *ectx, isntype_T isn_type, isn_T *iptr)
 	default:  // Cannot reach here
 	    return NOTDONE;
     }
-    di = find_var_in_ht(ht, 0, iptr->isn_arg.string, TRUE);
+    di = find_item_cached(ht, name, cachep);
 
     if (di == NULL)
     {
 	if (isn_type == ISN_LOADG)
 	{
-	    ufunc_T *ufunc = find_func(iptr->isn_arg.string, TRUE);
+	    ufunc_T *ufunc = find_func(name, TRUE);
 
 	    // g:Something could be a function
 	    if (ufunc != NULL)
@@ -2421,22 +2501,21 @@ load_namespace_var(ectx_T *ectx, isntype_T isn_type, isn_T *iptr)
 
 		++ectx->ec_stack.ga_len;
 		tv->v_type = VAR_FUNC;
-		tv->vval.v_string = alloc(STRLEN(iptr->isn_arg.string) + 3);
+		tv->vval.v_string = alloc(STRLEN(name) + 3);
 		if (tv->vval.v_string == NULL)
 		    return FAIL;
 		STRCPY(tv->vval.v_string, "g:");
-		STRCPY(tv->vval.v_string + 2, iptr->isn_arg.string);
+		STRCPY(tv->vval.v_string + 2, name);
 		return OK;
 	    }
 	}
 	SOURCING_LNUM = iptr->isn_lnum;
-	if (vim_strchr(iptr->isn_arg.string, AUTOLOAD_CHAR) != NULL)
+	if (vim_strchr(name, AUTOLOAD_CHAR) != NULL)
 	    // no check if the item exists in the script but
 	    // isn't exported, it is too complicated
-	    semsg(_(e_item_not_found_in_script_str), iptr->isn_arg.string);
+	    semsg(_(e_item_not_found_in_script_str), name);
 	else
-	    semsg(_(e_undefined_variable_char_str),
-					      namespace, iptr->isn_arg.string);
+	    semsg(_(e_undefined_variable_char_str), namespace, name);
 	return FAIL;
     }
     else
@@ -2457,6 +2536,41 @@ exec_instructions(ectx_T *ectx)
     int		ret = FAIL;
     int		save_trylevel_at_start = ectx->ec_trylevel_at_start;
     int		dict_stack_len_at_start = dict_stack.ga_len;
+#ifdef USE_LABELS_AS_VALUES
+    static void	*exec_label[ISN_FINISH + 1];
+
+    if (exec_label[ISN_FINISH] == NULL)
+    {
+	int	i;
+
+	// Other instructions go through the top of the loop.
+	for (i = 0; i <= ISN_FINISH; ++i)
+	    exec_label[i] = &&not_labeled;
+	exec_label[ISN_LOAD] = &&isn_load;
+	exec_label[ISN_LOADSCRIPT] = &&isn_loadscript;
+	exec_label[ISN_STORE] = &&isn_store;
+	exec_label[ISN_STORENR] = &&isn_storenr;
+	exec_label[ISN_ADDNR] = &&isn_addnr;
+	exec_label[ISN_PUSHNR] = &&isn_push;
+	exec_label[ISN_PUSHBOOL] = &&isn_push;
+	exec_label[ISN_PUSHSPEC] = &&isn_push;
+	exec_label[ISN_PUSHF] = &&isn_push;
+	exec_label[ISN_PUSHS] = &&isn_push;
+	exec_label[ISN_PUSHBLOB] = &&isn_push;
+	exec_label[ISN_PUSHFUNC] = &&isn_push;
+	exec_label[ISN_PUSHCHANNEL] = &&isn_push;
+	exec_label[ISN_PUSHJOB] = &&isn_push;
+	exec_label[ISN_DCALL] = &&isn_dcall;
+	exec_label[ISN_BCALL] = &&isn_bcall;
+	exec_label[ISN_RETURN] = &&isn_return;
+	exec_label[ISN_JUMP] = &&isn_jump;
+	exec_label[ISN_COMPARENR_JUMP] = &&isn_comparenr_jump;
+	exec_label[ISN_FOR] = &&isn_for;
+	exec_label[ISN_OPNR] = &&isn_opnr;
+	exec_label[ISN_COMPARENR] = &&isn_opnr;
+	exec_label[ISN_DROP] = &&isn_drop;
+    }
+#endif
 
     // Start execution at the first instruction.
     ectx->ec_iidx = 0;
@@ -2912,11 +3026,21 @@ exec_instructions(ectx_T *ectx)
 
 	    // load local variable or argument
 	    case ISN_LOAD:
+	    INSTR_LABEL(isn_load)
 		if (GA_GROW_FAILS(&ectx->ec_stack, 1))
 		    goto theend;
-		copy_tv(STACK_TV_VAR(iptr->isn_arg.number), STACK_TV_BOT(0));
+		tv = STACK_TV_VAR(iptr->isn_arg.number);
+		// Most local variables are a number or bool, copying them
+		// directly avoids the copy_tv() call.
+		if (TV_HAS_NO_ALLOC(tv))
+		{
+		    *STACK_TV_BOT(0) = *tv;
+		    STACK_TV_BOT(0)->v_lock = 0;
+		}
+		else
+		    copy_tv(tv, STACK_TV_BOT(0));
 		++ectx->ec_stack.ga_len;
-		break;
+		NEXT_INSTR;
 
 	    // load v: variable
 	    case ISN_LOADV:
@@ -2928,6 +3052,7 @@ exec_instructions(ectx_T *ectx)
 
 	    // load s: variable in Vim9 script
 	    case ISN_LOADSCRIPT:
+	    INSTR_LABEL(isn_loadscript)
 		{
 		    scriptref_T	*sref = iptr->isn_arg.script.scriptref;
 		    svar_T	 *sv;
@@ -2941,7 +3066,7 @@ exec_instructions(ectx_T *ectx)
 		    copy_tv(sv->sv_tv, STACK_TV_BOT(0));
 		    ++ectx->ec_stack.ga_len;
 		}
-		break;
+		NEXT_INSTR;
 
 	    // load s: variable in old script or autoload import
 	    case ISN_LOADS:
@@ -2993,7 +3118,9 @@ exec_instructions(ectx_T *ectx)
 	    case ISN_LOADW:
 	    case ISN_LOADT:
 		{
-		    int res = load_namespace_var(ectx, iptr->isn_type, iptr);
+		    int res = load_namespace_var(ectx, iptr->isn_type, iptr,
+					       iptr->isn_arg.loadname.ln_name,
+					      &iptr->isn_arg.loadname.ln_cache);
 
 		    if (res == NOTDONE)
 			goto theend;
@@ -3094,11 +3221,13 @@ exec_instructions(ectx_T *ectx)
 
 	    // store local variable
 	    case ISN_STORE:
+	    INSTR_LABEL(isn_store)
 		--ectx->ec_stack.ga_len;
 		tv = STACK_TV_VAR(iptr->isn_arg.number);
-		clear_tv(tv);
+		if (!TV_HAS_NO_ALLOC(tv))
+		    clear_tv(tv);
 		*tv = *STACK_TV_BOT(0);
-		break;
+		NEXT_INSTR;
 
 	    // store s: variable in old script or autoload import
 	    case ISN_STORES:
@@ -3313,11 +3442,21 @@ exec_instructions(ectx_T *ectx)
 
 	    // store number in local variable
 	    case ISN_STORENR:
+	    INSTR_LABEL(isn_storenr)
 		tv = STACK_TV_VAR(iptr->isn_arg.storenr.stnr_idx);
-		clear_tv(tv);
+		if (!TV_HAS_NO_ALLOC(tv))
+		    clear_tv(tv);
 		tv->v_type = VAR_NUMBER;
+		tv->v_lock = 0;
 		tv->vval.v_number = iptr->isn_arg.storenr.stnr_val;
-		break;
+		NEXT_INSTR;
+
+	    // add number to local variable, like "var += 1"
+	    case ISN_ADDNR:
+	    INSTR_LABEL(isn_addnr)
+		tv = STACK_TV_VAR(iptr->isn_arg.storenr.stnr_idx);
+		tv->vval.v_number += iptr->isn_arg.storenr.stnr_val;
+		NEXT_INSTR;
 
 	    // store value in list or dict variable
 	    case ISN_STOREINDEX:
@@ -3403,6 +3542,7 @@ exec_instructions(ectx_T *ectx)
 	    case ISN_PUSHFUNC:
 	    case ISN_PUSHCHANNEL:
 	    case ISN_PUSHJOB:
+	    INSTR_LABEL(isn_push)
 		if (GA_GROW_FAILS(&ectx->ec_stack, 1))
 		    goto theend;
 		tv = STACK_TV_BOT(0);
@@ -3456,7 +3596,7 @@ exec_instructions(ectx_T *ectx)
 			tv->vval.v_string = iptr->isn_arg.string == NULL
 				    ? NULL : vim_strsave(iptr->isn_arg.string);
 		}
-		break;
+		NEXT_INSTR;
 
 	    case ISN_AUTOLOAD:
 		{
@@ -3475,7 +3615,8 @@ exec_instructions(ectx_T *ectx)
 		    }
 		    else
 		    {
-			int res = load_namespace_var(ectx, ISN_LOADG, iptr);
+			int res = load_namespace_var(ectx, ISN_LOADG, iptr,
+								   name, NULL);
 
 			if (res == NOTDONE)
 			    goto theend;
@@ -3549,6 +3690,7 @@ exec_instructions(ectx_T *ectx)
 
 	    // call a :def function
 	    case ISN_DCALL:
+	    INSTR_LABEL(isn_dcall)
 		SOURCING_LNUM = iptr->isn_lnum;
 		if (call_dfunc(iptr->isn_arg.dfunc.cdf_idx,
 				NULL,
@@ -3559,6 +3701,7 @@ exec_instructions(ectx_T *ectx)
 
 	    // call a builtin function
 	    case ISN_BCALL:
+	    INSTR_LABEL(isn_bcall)
 		SOURCING_LNUM = iptr->isn_lnum;
 		if (call_bfunc(iptr->isn_arg.bfunc.cbf_idx,
 			      iptr->isn_arg.bfunc.cbf_argcount,
@@ -3628,6 +3771,7 @@ exec_instructions(ectx_T *ectx)
 
 	    // return from a :def function call with what is on the stack
 	    case ISN_RETURN:
+	    INSTR_LABEL(isn_return)
 		{
 		    garray_T	*trystack = &ectx->ec_trystack;
 		    trycmd_T    *trycmd = NULL;
@@ -3721,6 +3865,7 @@ exec_instructions(ectx_T *ectx)
 
 	    // jump if a condition is met
 	    case ISN_JUMP:
+	    INSTR_LABEL(isn_jump)
 		{
 		    jumpwhen_T	when = iptr->isn_arg.jump.jump_when;
 		    int		error = FALSE;
@@ -3753,6 +3898,8 @@ exec_instructions(ectx_T *ectx)
 		    }
 		    if (jump)
 			ectx->ec_iidx = iptr->isn_arg.jump.jump_where;
+		    if (ectx->ec_iidx > iptr - ectx->ec_instr)
+			NEXT_INSTR;
 		}
 		break;
 
@@ -3766,8 +3913,35 @@ exec_instructions(ectx_T *ectx)
 		    ectx->ec_iidx = iptr->isn_arg.jumparg.jump_where;
 		break;
 
+	    // compare two numbers and jump if the result is false
+	    case ISN_COMPARENR_JUMP:
+	    INSTR_LABEL(isn_comparenr_jump)
+		{
+		    varnumber_T arg1 = STACK_TV_BOT(-2)->vval.v_number;
+		    varnumber_T arg2 = STACK_TV_BOT(-1)->vval.v_number;
+		    int		res;
+
+		    switch (iptr->isn_arg.cmpjump.cj_op.op_type)
+		    {
+			case EXPR_EQUAL: res = arg1 == arg2; break;
+			case EXPR_NEQUAL: res = arg1 != arg2; break;
+			case EXPR_GREATER: res = arg1 > arg2; break;
+			case EXPR_GEQUAL: res = arg1 >= arg2; break;
+			case EXPR_SMALLER: res = arg1 < arg2; break;
+			case EXPR_SEQUAL: res = arg1 <= arg2; break;
+			default: res = FALSE; break;
+		    }
+		    ectx->ec_stack.ga_len -= 2;
+		    if (!res)
+			ectx->ec_iidx = iptr->isn_arg.cmpjump.cj_where;
+		    if (ectx->ec_iidx > iptr - ectx->ec_instr)
+			NEXT_INSTR;
+		}
+		break;
+
 	    // top of a for loop
 	    case ISN_FOR:
+	    INSTR_LABEL(isn_for)
 		if (execute_for(iptr, ectx) == FAIL)
 		    goto theend;
 		break;
@@ -4009,6 +4183,7 @@ exec_instructions(ectx_T *ectx)
 	    // Operation with two number arguments
 	    case ISN_OPNR:
 	    case ISN_COMPARENR:
+	    INSTR_LABEL(isn_opnr)
 		{
 		    typval_T	*tv1 = STACK_TV_BOT(-2);
 		    typval_T	*tv2 = STACK_TV_BOT(-1);
@@ -4057,7 +4232,7 @@ exec_instructions(ectx_T *ectx)
 			goto on_error;
 		    }
 		}
-		break;
+		NEXT_INSTR;
 
 	    // Computation with two float arguments
 	    case ISN_OPFLOAT:
@@ -4572,12 +4747,14 @@ exec_instructions(ectx_T *ectx)
 		    }
 		    dict = tv->vval.v_dict;
 
-		    if ((di = dict_find(dict, iptr->isn_arg.string, -1))
+		    if ((di = find_item_cached(&dict->dv_hashtab,
+					iptr->isn_arg.loadname.ln_name,
+					&iptr->isn_arg.loadname.ln_cache))
 								       == NULL)
 		    {
 			SOURCING_LNUM = iptr->isn_lnum;
 			semsg(_(e_key_not_present_in_dictionary),
-							 iptr->isn_arg.string);
+					       iptr->isn_arg.loadname.ln_name);
 			goto on_error;
 		    }
 		    // Put the dict used on the dict stack, it might be used by
@@ -4933,14 +5110,23 @@ exec_instructions(ectx_T *ectx)
 		break;
 
 	    case ISN_DROP:
+	    INSTR_LABEL(isn_drop)
 		--ectx->ec_stack.ga_len;
-		clear_tv(STACK_TV_BOT(0));
+		if (!TV_HAS_NO_ALLOC(STACK_TV_BOT(0)))
+		    clear_tv(STACK_TV_BOT(0));
 		ectx->ec_where.wt_index = 0;
 		ectx->ec_where.wt_variable = FALSE;
-		break;
+		NEXT_INSTR;
 	}
 	continue;
 
+#ifdef USE_LABELS_AS_VALUES
+not_labeled:
+	// Go through the checks at the top of the loop and the switch.
+	--ectx->ec_iidx;
+	continue;
+#endif
+
 func_return:
 	// Restore previous function. If the frame pointer is where we started
 	// then there is none and we are done.
@@ -5610,16 +5796,20 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 		smsg("%s%4d LOADAUTO %s", pfx, current, iptr->isn_arg.string);
 		break;
 	    case ISN_LOADG:
-		smsg("%s%4d LOADG g:%s", pfx, current, iptr->isn_arg.string);
+		smsg("%s%4d LOADG g:%s", pfx, current,
+					       iptr->isn_arg.loadname.ln_name);
 		break;
 	    case ISN_LOADB:
-		smsg("%s%4d LOADB b:%s", pfx, current, iptr->isn_arg.string);
+		smsg("%s%4d LOADB b:%s", pfx, current,
+					       iptr->isn_arg.loadname.ln_name);
 		break;
 	    case ISN_LOADW:
-		smsg("%s%4d LOADW w:%s", pfx, current, iptr->isn_arg.string);
+		smsg("%s%4d LOADW w:%s", pfx, current,
+					       iptr->isn_arg.loadname.ln_name);
 		break;
 	    case ISN_LOADT:
-		smsg("%s%4d LOADT t:%s", pfx, current, iptr->isn_arg.string);
+		smsg("%s%4d LOADT t:%s", pfx, current,
+					       iptr->isn_arg.loadname.ln_name);
 		break;
 	    case ISN_LOADGDICT:
 		smsg("%s%4d LOAD g:", pfx, current);
@@ -5730,6 +5920,11 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 				iptr->isn_arg.storenr.stnr_val,
 				iptr->isn_arg.storenr.stnr_idx);
 		break;
+	    case ISN_ADDNR:
+		smsg("%s%4d ADDNR %lld to $%d", pfx, current,
+				iptr->isn_arg.storenr.stnr_val,
+				iptr->isn_arg.storenr.stnr_idx);
+		break;
 
 	    case ISN_STOREINDEX:
 		smsg("%s%4d STOREINDEX %s", pfx, current,
@@ -6028,6 +6223,7 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 	    case ISN_COMPARESPECIAL:
 	    case ISN_COMPARENULL:
 	    case ISN_COMPARENR:
+	    case ISN_COMPARENR_JUMP:
 	    case ISN_COMPAREFLOAT:
 	    case ISN_COMPARESTRING:
 	    case ISN_COMPAREBLOB:
@@ -6039,8 +6235,10 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 		       char *p;
 		       char buf[10];
 		       char *type;
+		       opexpr_T *op = iptr->isn_type == ISN_COMPARENR_JUMP
+				 ? &iptr->isn_arg.cmpjump.cj_op : &iptr->isn_arg.op;
 
-		       switch (iptr->isn_arg.op.op_type)
+		       switch (op->op_type)
 		       {
 			   case EXPR_EQUAL:	 p = "=="; break;
 			   case EXPR_NEQUAL:    p = "!="; break;
@@ -6055,7 +6253,7 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 			   default:  p = "???"; break;
 		       }
 		       STRCPY(buf, p);
-		       if (iptr->isn_arg.op.op_ic == TRUE)
+		       if (op->op_ic == TRUE)
 			   strcat(buf, "?");
 		       switch(iptr->isn_type)
 		       {
@@ -6064,6 +6262,8 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 						 type = "COMPARESPECIAL"; break;
 			   case ISN_COMPARENULL: type = "COMPARENULL"; break;
 			   case ISN_COMPARENR: type = "COMPARENR"; break;
+			   case ISN_COMPARENR_JUMP:
+						type = "COMPARENR_JUMP"; break;
 			   case ISN_COMPAREFLOAT: type = "COMPAREFLOAT"; break;
 			   case ISN_COMPARESTRING:
 						  type = "COMPARESTRING"; break;
@@ -6075,7 +6275,11 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 			   default: type = "???"; break;
 		       }
 
-		       smsg("%s%4d %s %s", pfx, current, type, buf);
+		       if (iptr->isn_type == ISN_COMPARENR_JUMP)
+			   smsg("%s%4d %s %s -> %d", pfx, current, type, buf,
+					       iptr->isn_arg.cmpjump.cj_where);
+		       else
+			   smsg("%s%4d %s %s", pfx, current, type, buf);
 		   }
 		   break;
 
@@ -6102,7 +6306,7 @@ list_instructions(char *pfx, isn_T *instr, int instr_count, ufunc_T *ufunc)
 						       " with op" : ""); break;
 	    case ISN_MEMBER: smsg("%s%4d MEMBER", pfx, current); break;
 	    case ISN_STRINGMEMBER: smsg("%s%4d MEMBER %s", pfx, current,
-						  iptr->isn_arg.string); break;
+					iptr->isn_arg.loadname.ln_name); break;
 	    case ISN_CLEARDICT: smsg("%s%4d CLEARDICT", pfx, current); break;
 	    case ISN_USEDICT: smsg("%s%4d USEDICT", pfx, current); break;
 
@@ -968,10 +968,16 @@ generate_LOAD(
     RETURN_OK_IF_SKIP(cctx);
     if ((isn = generate_instr_type2(cctx, isn_type, type, type)) == NULL)
 	return FAIL;
-    if (name != NULL)
-	isn->isn_arg.string = vim_strsave(name);
-    else
+    if (name == NULL)
 	isn->isn_arg.number = idx;
+    else if (isn_type == ISN_LOADG || isn_type == ISN_LOADB
+				|| isn_type == ISN_LOADW || isn_type == ISN_LOADT)
+    {
+	isn->isn_arg.loadname.ln_name = vim_strsave(name);
+	isn->isn_arg.loadname.ln_cache = NULL;
+    }
+    else
+	isn->isn_arg.string = vim_strsave(name);
 
     return OK;
 }
@@ -1671,7 +1677,8 @@ generate_STRINGMEMBER(cctx_T *cctx, char_u *name, size_t len)
     RETURN_OK_IF_SKIP(cctx);
     if ((isn = generate_instr(cctx, ISN_STRINGMEMBER)) == NULL)
 	return FAIL;
-    isn->isn_arg.string = vim_strnsave(name, len);
+    isn->isn_arg.loadname.ln_name = vim_strnsave(name, len);
+    isn->isn_arg.loadname.ln_cache = NULL;
 
     // check for dict type
     type = get_type_on_stack(cctx, 0);
@@ -2031,6 +2038,177 @@ may_generate_prof_end(cctx_T *cctx, int prof_lnum)
 }
 #endif
 
+/*
+ * Store pointers to the instruction indexes that "isn" may jump to in
+ * "where[]", which must have room for three.  Returns the number of pointers.
+ */
+    static int
+get_jump_targets(isn_T *isn, int **where)
+{
+    switch (isn->isn_type)
+    {
+	case ISN_JUMP:
+	    where[0] = &isn->isn_arg.jump.jump_where;
+	    return 1;
+	case ISN_JUMP_IF_ARG_SET:
+	    where[0] = &isn->isn_arg.jumparg.jump_where;
+	    return 1;
+	case ISN_COMPARENR_JUMP:
+	    where[0] = &isn->isn_arg.cmpjump.cj_where;
+	    return 1;
+	case ISN_FOR:
+	    where[0] = &isn->isn_arg.forloop.for_end;
+	    return 1;
+	case ISN_TRYCONT:
+	    where[0] = &isn->isn_arg.trycont.tct_where;
+	    return 1;
+	case ISN_TRY:
+	    where[0] = &isn->isn_arg.tryref.try_ref->try_catch;
+	    where[1] = &isn->isn_arg.tryref.try_ref->try_finally;
+	    where[2] = &isn->isn_arg.tryref.try_ref->try_endtry;
+	    return 3;
+	default:
+	    return 0;
+    }
+}
+
+/*
+ * Optimize the instructions of a compiled function in "instr":
+ * - A jump to an unconditional jump goes to where that one jumps to.
+ * - An unconditional jump to the next instruction is dropped.
+ * - ISN_COMPARENR followed by a JUMP_IF_FALSE jump becomes one
+ *   ISN_COMPARENR_JUMP, as used for "if a < b" and "while i < n".
+ * - ISN_LOAD, ISN_PUSHNR, ISN_OPNR and ISN_STORE of the same local variable
+ *   become one ISN_ADDNR, as used for "i += 1".
+ * Instructions are only combined when no jump goes to the middle of them.
+ */
+    void
+optimize_instructions(garray_T *instr)
+{
+    isn_T	*isns = (isn_T *)instr->ga_data;
+    int		count = instr->ga_len;
+    char_u	*is_target;
+    int		*new_idx;
+    int		*where[3];
+    int		n;
+    int		i;
+    int		j;
+    int		new_count = 0;
+
+    if (count == 0)
+	return;
+    is_target = alloc_clear(count + 1);
+    new_idx = ALLOC_MULT(int, count + 1);
+    if (is_target == NULL || new_idx == NULL)
+    {
+	vim_free(is_target);
+	vim_free(new_idx);
+	return;
+    }
+
+    for (i = 0; i < count; ++i)
+    {
+	isn_T	*isn = isns + i;
+
+	if (isn->isn_type == ISN_JUMP)
+	{
+	    int	    hops;
+
+	    // Limit the number of hops, jumps may go around in a loop.
+	    for (hops = 0; hops < 10; ++hops)
+	    {
+		isn_T	*target;
+
+		if (isn->isn_arg.jump.jump_where >= count)
+		    break;
+		target = isns + isn->isn_arg.jump.jump_where;
+		if (target == isn || target->isn_type != ISN_JUMP
+			|| target->isn_arg.jump.jump_when != JUMP_ALWAYS)
+		    break;
+		isn->isn_arg.jump.jump_where = target->isn_arg.jump.jump_where;
+	    }
+	}
+	n = get_jump_targets(isn, where);
+	for (j = 0; j < n; ++j)
+	    if (*where[j] >= 0 && *where[j] <= count)
+		is_target[*where[j]] = TRUE;
+    }
+
+    // "new_idx" is -1 for an instruction that is dropped.
+    for (i = 0; i < count; ++i)
+    {
+	isn_T	*isn = isns + i;
+
+	new_idx[i] = 0;
+	if (isn->isn_type == ISN_JUMP
+		&& isn->isn_arg.jump.jump_when == JUMP_ALWAYS
+		&& isn->isn_arg.jump.jump_where == i + 1)
+	    new_idx[i] = -1;
+	else if (isn->isn_type == ISN_COMPARENR && i + 1 < count
+		&& isn[1].isn_type == ISN_JUMP
+		&& isn[1].isn_arg.jump.jump_when == JUMP_IF_FALSE
+		&& !is_target[i + 1])
+	{
+	    opexpr_T	op = isn->isn_arg.op;
+
+	    isn->isn_type = ISN_COMPARENR_JUMP;
+	    isn->isn_arg.cmpjump.cj_op = op;
+	    isn->isn_arg.cmpjump.cj_where = isn[1].isn_arg.jump.jump_where;
+	    new_idx[++i] = -1;
+	}
+	else if (isn->isn_type == ISN_LOAD && i + 3 < count
+		&& isn[1].isn_type == ISN_PUSHNR
+		&& isn[2].isn_type == ISN_OPNR
+		&& (isn[2].isn_arg.op.op_type == EXPR_ADD
+		    || (isn[2].isn_arg.op.op_type == EXPR_SUB
+				 && isn[1].isn_arg.number != VARNUM_MIN))
+		&& isn[3].isn_type == ISN_STORE
+		&& isn[3].isn_arg.number == isn->isn_arg.number
+		&& !is_target[i + 1] && !is_target[i + 2] && !is_target[i + 3])
+	{
+	    int		idx = isn->isn_arg.number;
+	    varnumber_T	val = isn[1].isn_arg.number;
+
+	    isn->isn_type = ISN_ADDNR;
+	    isn->isn_arg.storenr.stnr_idx = idx;
+	    isn->isn_arg.storenr.stnr_val =
+			 isn[2].isn_arg.op.op_type == EXPR_SUB ? -val : val;
+	    new_idx[++i] = -1;
+	    new_idx[++i] = -1;
+	    new_idx[++i] = -1;
+	}
+    }
+
+    // Move the remaining instructions up.  A jump to a dropped instruction
+    // goes to the instruction that follows it.
+    for (i = 0; i < count; ++i)
+    {
+	if (new_idx[i] < 0)
+	    new_idx[i] = new_count;
+	else
+	{
+	    new_idx[i] = new_count;
+	    isns[new_count++] = isns[i];
+	}
+    }
+    new_idx[count] = new_count;
+
+    if (new_count < count)
+    {
+	for (i = 0; i < new_count; ++i)
+	{
+	    n = get_jump_targets(isns + i, where);
+	    for (j = 0; j < n; ++j)
+		if (*where[j] >= 0 && *where[j] <= count)
+		    *where[j] = new_idx[*where[j]];
+	}
+	instr->ga_len = new_count;
+    }
+
+    vim_free(is_target);
+    vim_free(new_idx);
+}
+
 
 /*
  * Delete an instruction, free what it contains.
@@ -2047,12 +2225,8 @@ delete_instr(isn_T *isn)
 	case ISN_EXEC_SPLIT:
 	case ISN_LEGACY_EVAL:
 	case ISN_LOADAUTO:
-	case ISN_LOADB:
 	case ISN_LOADENV:
-	case ISN_LOADG:
 	case ISN_LOADOPT:
-	case ISN_LOADT:
-	case ISN_LOADW:
 	case ISN_LOCKUNLOCK:
 	case ISN_PUSHEXC:
 	case ISN_PUSHFUNC:
@@ -2064,10 +2238,18 @@ delete_instr(isn_T *isn)
 	case ISN_STOREG:
 	case ISN_STORET:
 	case ISN_STOREW:
-	case ISN_STRINGMEMBER:
 	    vim_free(isn->isn_arg.string);
 	    break;
 
+	case ISN_LOADB:
+	case ISN_LOADG:
+	case ISN_LOADT:
+	case ISN_LOADW:
+	case ISN_STRINGMEMBER:
+	    vim_free(isn->isn_arg.loadname.ln_name);
+	    vim_free(isn->isn_arg.loadname.ln_cache);
+	    break;
+
 	case ISN_SUBSTITUTE:
 	    {
 		int	idx;
@@ -2206,6 +2388,7 @@ delete_instr(isn_T *isn)
 	case ISN_CHECKLEN:
 	case ISN_CHECKNR:
 	case ISN_CLEARDICT:
+	case ISN_ADDNR:
 	case ISN_CMDMOD_REV:
 	case ISN_COMPAREANY:
 	case ISN_COMPAREBLOB:
@@ -2215,6 +2398,7 @@ delete_instr(isn_T *isn)
 	case ISN_COMPAREFUNC:
 	case ISN_COMPARELIST:
 	case ISN_COMPARENR:
+	case ISN_COMPARENR_JUMP:
 	case ISN_COMPARENULL:
 	case ISN_COMPARESPECIAL:
 	case ISN_COMPARESTRING:
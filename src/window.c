@@ -5421,7 +5421,10 @@ win_free_lsize(win_T *wp)
 {
     // TODO: why would wp be NULL here?
     if (wp != NULL)
+    {
 	VIM_CLEAR(wp->w_lines);
+	linecache_free(wp);
+    }
 }
 
 /*